@@ -10,11 +10,8 @@ using namespace servos;
 using namespace controllers;
 using namespace protocols;
 
-template <class Protocol>
-std::string string_operating_mode(Usb2Dynamixel& controller, typename Protocol::id_t id)
+std::string string_operating_mode(OperatingMode mode)
 {
-    OperatingMode mode = operating_mode<Protocol>(controller, id);
-
     std::string str_mode;
     switch (mode) {
     case OperatingMode::wheel:
@@ -32,6 +29,28 @@ std::string string_operating_mode(Usb2Dynamixel& controller, typename Protocol::
     return str_mode;
 }
 
+// Query the operating mode of all the detected actuators, in one instruction
+template <class Protocol>
+void print_operating_modes(Usb2Dynamixel& controller,
+    const std::vector<std::shared_ptr<BaseServo<Protocol>>>& servos)
+{
+    std::vector<typename Protocol::id_t> ids;
+    for (auto servo : servos)
+        ids.push_back(servo->id());
+
+    std::vector<ReadStatus> statuses;
+    std::vector<OperatingMode> modes = operating_modes<Protocol>(controller, ids, statuses);
+
+    for (size_t i = 0; i < servos.size(); ++i) {
+        std::cout << "Detected an " << servos[i]->model_name()
+                  << " with ID " << servos[i]->id();
+        if (statuses[i] == ReadStatus::ok)
+            std::cout << ", in " << string_operating_mode(modes[i]) << " mode" << std::endl;
+        else
+            std::cout << ", whose mode could not be read (" << status2str(statuses[i]) << ")" << std::endl;
+    }
+}
+
 int main(int argc, char** argv)
 {
     if (argc != 3 || (argc == 2 && 0 == strcmp(argv[1], "--help"))) {
@@ -52,12 +71,7 @@ int main(int argc, char** argv)
             std::vector<std::shared_ptr<BaseServo<Protocol1>>> servos_1 = auto_detect<Protocol1>(controller);
 
             if (servos_1.size()) {
-                for (auto servo : servos_1) {
-                    std::string str_mode = string_operating_mode<Protocol1>(controller, servo->id());
-                    std::cout << "Detected an " << servo->model_name()
-                              << " with ID " << servo->id()
-                              << ", in " << str_mode << " mode" << std::endl;
-                }
+                print_operating_modes(controller, servos_1);
             }
             else {
                 std::cout << "No dynamixel detected" << std::endl;
@@ -67,12 +81,7 @@ int main(int argc, char** argv)
             std::vector<std::shared_ptr<BaseServo<Protocol2>>> servos_2 = auto_detect<Protocol2>(controller);
 
             if (servos_2.size()) {
-                for (auto servo : servos_2) {
-                    std::string str_mode = string_operating_mode<Protocol2>(controller, servo->id());
-                    std::cout << "Detected an " << servo->model_name()
-                              << " with ID " << servo->id()
-                              << ", in " << str_mode << " mode" << std::endl;
-                }
+                print_operating_modes(controller, servos_2);
             }
             else {
                 std::cout << "No dynamixel detected" << std::endl;
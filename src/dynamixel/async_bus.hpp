@@ -0,0 +1,275 @@
+#ifndef DYNAMIXEL_ASYNC_BUS_HPP_
+#define DYNAMIXEL_ASYNC_BUS_HPP_
+
+#include <stdint.h>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <errno.h>
+#include <functional>
+#include <future>
+#include <memory>
+#include <poll.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "controllers/usb2dynamixel.hpp"
+#include "errors/error.hpp"
+#include "instruction_packet.hpp"
+#include "protocols/decode_report.hpp"
+#include "read_result.hpp"
+#include "status_packet.hpp"
+
+namespace dynamixel {
+    /// Outcome of a transaction of an AsyncBus
+    template <class Protocol>
+    struct AsyncResult {
+        /// ReadStatus::ok once sent, for the transactions without reply
+        ReadStatus status;
+        /// reply of the actuator (when status is ok or servo_error)
+        StatusPacket<Protocol> reply;
+    };
+
+    /** Transactions on a bus driven by an event loop, instead of blocking the
+        caller until the replies arrive.
+
+        A transaction is submitted along with a callback, or gives a future.
+        The application watches the file descriptor of the bus (`fd`) with its
+        own reactor (epoll, poll, select...), calls `on_readable` when data
+        arrived, and `process` when the timeout given by `timeout_ms` expired:
+
+            AsyncBus<Protocol1> bus(controller);
+            bus.submit(Read<Protocol1>(1, 36, 2), 1,
+                [](const AsyncResult<Protocol1>& result) { ... });
+            std::future<AsyncResult<Protocol1>> pong = bus.submit(Ping<Protocol1>(2), 2);
+
+            // in the event loop
+            epoll_event event;
+            event.events = EPOLLIN;
+            event.data.fd = bus.fd();
+            epoll_ctl(epoll_fd, EPOLL_CTL_ADD, bus.fd(), &event);
+            ...
+            int n = epoll_wait(epoll_fd, events, max_events, bus.timeout_ms());
+            if (events[i].data.fd == bus.fd())
+                bus.on_readable();
+            bus.process();
+
+        The transactions are executed in the order of submission, one at a
+        time since the bus is half-duplex. The packets are written when the
+        bus is free (the write itself is short and does not wait for the
+        actuators); the callbacks are called from `submit`, `on_readable` or
+        `process`, and may submit new transactions.
+
+        The controller has to give its file descriptor (`fd()`) and a raw send
+        (`send(const uint8_t*, size_t)`); the descriptor should not block on
+        read (Usb2Dynamixel configures the port this way).
+    **/
+    template <class Protocol, class Controller = controllers::Usb2Dynamixel>
+    class AsyncBus {
+    public:
+        typedef typename Protocol::id_t id_t;
+        typedef std::function<void(const AsyncResult<Protocol>&)> callback_t;
+        typedef std::chrono::steady_clock clock_t;
+
+        /** @param controller object handling the USB to dynamixel interface
+            @param recv_timeout time without receiving any byte after which a
+                reply is considered lost, in seconds
+        **/
+        AsyncBus(const Controller& controller, double recv_timeout = 0.02)
+            : _controller(controller), _recv_timeout(recv_timeout), _in_flight(false), _starting(false) {}
+
+        /// File descriptor to watch for readability
+        int fd() const { return _controller.fd(); }
+
+        /// Submit an instruction to which no actuator replies
+        void submit(const InstructionPacket<Protocol>& packet, const callback_t& callback)
+        {
+            _Transaction transaction = {packet, false, 0, callback};
+            _queue.push_back(transaction);
+            _start_next();
+        }
+
+        /// Submit an instruction to which the actuator reply_id replies
+        void submit(const InstructionPacket<Protocol>& packet, id_t reply_id, const callback_t& callback)
+        {
+            _Transaction transaction = {packet, true, reply_id, callback};
+            _queue.push_back(transaction);
+            _start_next();
+        }
+
+        /// @see submit(const InstructionPacket<Protocol>&, const callback_t&)
+        std::future<AsyncResult<Protocol>> submit(const InstructionPacket<Protocol>& packet)
+        {
+            std::shared_ptr<std::promise<AsyncResult<Protocol>>> promise(new std::promise<AsyncResult<Protocol>>);
+            std::future<AsyncResult<Protocol>> future = promise->get_future();
+            submit(packet, _fulfil(promise));
+            return future;
+        }
+
+        /// @see submit(const InstructionPacket<Protocol>&, id_t, const callback_t&)
+        std::future<AsyncResult<Protocol>> submit(const InstructionPacket<Protocol>& packet, id_t reply_id)
+        {
+            std::shared_ptr<std::promise<AsyncResult<Protocol>>> promise(new std::promise<AsyncResult<Protocol>>);
+            std::future<AsyncResult<Protocol>> future = promise->get_future();
+            submit(packet, reply_id, _fulfil(promise));
+            return future;
+        }
+
+        /// Number of transactions not completed yet
+        size_t pending() const { return _queue.size(); }
+
+        /** Time until the reply being awaited is considered lost, in
+            milliseconds (rounded up), or -1 if no reply is awaited; suitable
+            as the timeout of epoll_wait or poll.
+        **/
+        int timeout_ms() const
+        {
+            if (!_in_flight)
+                return -1;
+            double remaining = std::chrono::duration_cast<std::chrono::duration<double>>(_deadline - clock_t::now()).count();
+            return remaining > 0 ? (int)std::ceil(remaining * 1e3) : 0;
+        }
+
+        /** Read the data available on the file descriptor, and complete the
+            transaction being awaited if its reply arrived.
+
+            @throws errors::Error if reading fails
+        **/
+        void on_readable()
+        {
+            uint8_t buffer[_read_size];
+            ssize_t n = ::read(fd(), buffer, sizeof(buffer));
+            if (n < 0 && errno != EAGAIN && errno != EINTR)
+                throw errors::Error("AsyncBus: read error: " + std::string(strerror(errno)));
+
+            for (ssize_t i = 0; i < n; ++i) {
+                _packet.push_back(buffer[i]);
+                protocols::DecodeReport report;
+                typename Protocol::DecodeState state = _status.decode_packet(_packet, report);
+                if (state == Protocol::INVALID) {
+                    if (report.error == protocols::DecodeError::checksum)
+                        _checksum_error = true;
+                    _packet.clear();
+                }
+                else if (state == Protocol::DONE) {
+                    _packet.clear();
+                    // replies of actuators that are not awaited are dropped
+                    if (_in_flight && _queue.front().reply_id == _status.id())
+                        _complete((0 == _status.error_byte()) ? ReadStatus::ok : ReadStatus::servo_error);
+                }
+            }
+
+            // like Usb2Dynamixel, the timeout applies between two bytes
+            if (n > 0 && _in_flight)
+                _deadline = clock_t::now() + _timeout_duration();
+            _start_next();
+        }
+
+        /// Complete the transaction being awaited if its timeout expired
+        void process()
+        {
+            if (_in_flight && clock_t::now() >= _deadline)
+                _complete(_checksum_error ? ReadStatus::checksum_error : ReadStatus::timeout);
+            _start_next();
+        }
+
+        /** Drive the bus with poll(2) until all the transactions completed
+            (for the programs that do not have an event loop).
+        **/
+        void run()
+        {
+            while (pending() > 0) {
+                struct pollfd descriptor = {fd(), POLLIN, 0};
+                if (poll(&descriptor, 1, timeout_ms()) > 0)
+                    on_readable();
+                process();
+            }
+        }
+
+    protected:
+        struct _Transaction {
+            InstructionPacket<Protocol> packet;
+            bool reply;
+            id_t reply_id;
+            callback_t callback;
+        };
+
+        static callback_t _fulfil(std::shared_ptr<std::promise<AsyncResult<Protocol>>> promise)
+        {
+            return [promise](const AsyncResult<Protocol>& result) { promise->set_value(result); };
+        }
+
+        clock_t::duration _timeout_duration() const
+        {
+            return std::chrono::duration_cast<clock_t::duration>(std::chrono::duration<double>(_recv_timeout));
+        }
+
+        // sets a flag for the lifetime of the guard, even if an exception is thrown
+        struct _FlagGuard {
+            explicit _FlagGuard(bool& flag) : _flag(flag) { _flag = true; }
+            ~_FlagGuard() { _flag = false; }
+            bool& _flag;
+        };
+
+        // send the next transactions, until one of them awaits a reply
+        void _start_next()
+        {
+            // the callbacks may submit transactions: the outer call sends them
+            if (_starting)
+                return;
+            // the send or a callback may throw
+            _FlagGuard starting(_starting);
+
+            while (!_in_flight && !_queue.empty()) {
+                const _Transaction& next = _queue.front();
+                _controller.send(next.packet.data(), next.packet.size());
+
+                if (next.reply) {
+                    _in_flight = true;
+                    _checksum_error = false;
+                    _packet.clear();
+                    _deadline = clock_t::now() + _timeout_duration();
+                }
+                else
+                    _complete(ReadStatus::ok);
+            }
+        }
+
+        // remove the first transaction of the queue, and call its callback
+        void _complete(ReadStatus status)
+        {
+            AsyncResult<Protocol> result = {status, StatusPacket<Protocol>()};
+            if (_in_flight && (ReadStatus::ok == status || ReadStatus::servo_error == status))
+                result.reply = _status;
+
+            callback_t callback = _queue.front().callback;
+            _queue.pop_front();
+            _in_flight = false;
+            if (callback)
+                callback(result);
+        }
+
+        static const size_t _read_size = 256;
+
+        const Controller& _controller;
+        double _recv_timeout;
+        // transactions not completed yet; the first one is being executed
+        std::deque<_Transaction> _queue;
+
+        // whether the reply of the first transaction is awaited
+        bool _in_flight;
+        clock_t::time_point _deadline;
+        bool _checksum_error;
+        // whether _start_next is running
+        bool _starting;
+
+        // bytes received since the last complete (or discarded) packet
+        std::vector<uint8_t> _packet;
+        StatusPacket<Protocol> _status;
+    };
+} // namespace dynamixel
+
+#endif
@@ -4,6 +4,7 @@
 #include <memory>
 #include <map>
 
+#include "eeprom_cache.hpp"
 #include "errors/error.hpp"
 #include "servos.hpp"
 
@@ -109,6 +110,48 @@ namespace dynamixel {
         return std::shared_ptr<servos::BaseServo<Protocol>>();
     }
 
+    /** Send a ping to an ID and, if it is answered, instanciate a class of the
+        correct type, reading the model from an EEPROM cache.
+
+        The model is read along with the beginning of the EEPROM area (the part
+        that all the models have, see EepromCache::default_size), in a single
+        Read; this area stays in the cache, so that its other static fields
+        (return delay time, operating mode...) can later be used without
+        sending any packet. The size of the EEPROM area of the model is then
+        given to the cache.
+
+        @see find_servo(const Controller&, typename Protocol::id_t)
+
+        @param id value, from 1 to 254 identifiying an actuator
+        @param cache EEPROM cache, filled with the area of the actuator
+
+        @return std::shared_ptr to a servo object if we got an answer
+    **/
+    template <typename Protocol, typename Controller>
+    inline std::shared_ptr<servos::BaseServo<Protocol>>
+    find_servo(const Controller& controller, typename Protocol::id_t id, EepromCache<Protocol>& cache)
+    {
+        typename Protocol::address_t selected_protocol = 0;
+
+        try {
+            controller.send(instructions::Ping<Protocol>(id));
+            StatusPacket<Protocol> status;
+
+            if (controller.recv(status) && status.id() == id) {
+                cache.invalidate(id);
+                uint16_t model = cache.template get<uint16_t>(controller, id, 0);
+                std::shared_ptr<servos::BaseServo<Protocol>> servo = get_servo(id, model, selected_protocol);
+                cache.set_size(id, servo->eeprom_size());
+                return servo;
+            }
+        }
+        catch (const errors::Error&) {
+            // same behaviour as find_servo without cache
+        }
+
+        return std::shared_ptr<servos::BaseServo<Protocol>>();
+    }
+
     /** Auto-detect all connected actuators using a given protocol.
 
         The template parameter Controller is inferred from the function's
@@ -240,6 +283,48 @@ namespace dynamixel {
 
         return res;
     }
+
+    /** Auto-detect some actuators using a given protocol, and keep the
+        beginning of their EEPROM area in a cache.
+
+        @see find_servo(const Controller&, typename Protocol::id_t, EepromCache<Protocol>&)
+
+        @param controller object handling the USB to dynamixel interface, instance
+            of the dynamixel::controllers::Usb2Dynamixel class
+        @param ids vector of ids (1-254) that will be searched
+        @param cache EEPROM cache, filled with the area of the actuators found
+        @return map of the actuators found
+    **/
+    template <typename Protocol, typename Controller>
+    inline std::map<typename Protocol::id_t, std::shared_ptr<servos::BaseServo<Protocol>>>
+    auto_detect_map(
+        const Controller& controller,
+        const std::vector<typename Protocol::id_t>& ids,
+        EepromCache<Protocol>& cache)
+    {
+        using ServoPtr = std::shared_ptr<servos::BaseServo<Protocol>>;
+
+        std::map<typename Protocol::id_t, ServoPtr> res;
+
+        for (typename Protocol::id_t id : ids) {
+            ServoPtr servo = find_servo<Protocol>(controller, id, cache);
+            if (servo)
+                res[id] = servo;
+        }
+
+        return res;
+    }
+
+    /// @see auto_detect_map(const Controller&, const std::vector<typename Protocol::id_t>&, EepromCache<Protocol>&), on all the ids
+    template <typename Protocol, typename Controller>
+    inline std::map<typename Protocol::id_t, std::shared_ptr<servos::BaseServo<Protocol>>>
+    auto_detect_map(const Controller& controller, EepromCache<Protocol>& cache)
+    {
+        std::vector<typename Protocol::id_t> ids;
+        for (typename Protocol::id_t id = 0; id < Protocol::broadcast_id; id++)
+            ids.push_back(id);
+        return auto_detect_map<Protocol>(controller, ids, cache);
+    }
 } // namespace dynamixel
 
 #endif
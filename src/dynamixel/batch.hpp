@@ -0,0 +1,394 @@
+#ifndef DYNAMIXEL_BATCH_HPP_
+#define DYNAMIXEL_BATCH_HPP_
+
+#include <stdint.h>
+#include <cstddef>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "errors/error.hpp"
+#include "instruction_packet.hpp"
+#include "instructions/bulk_read.hpp"
+#include "instructions/bulk_write.hpp"
+#include "instructions/read.hpp"
+#include "instructions/sync_read.hpp"
+#include "instructions/sync_write_builder.hpp"
+#include "protocols/protocol1.hpp"
+#include "protocols/protocol2.hpp"
+#include "read_plan.hpp"
+#include "read_result.hpp"
+#include "send_queue.hpp"
+#include "status_packet.hpp"
+
+namespace dynamixel {
+    /** Whether the writes of a BatchWrite can be combined in a single bulk
+        write; this depends on the version of the protocol.
+    **/
+    template <class Protocol>
+    struct BatchWriteInstructions;
+
+    /// Protocol 1 has no bulk write
+    template <>
+    struct BatchWriteInstructions<protocols::Protocol1> {
+        typedef protocols::Protocol1 protocol_t;
+
+        static const bool has_bulk_write = false;
+
+        static InstructionPacket<protocol_t> bulk_write(const std::vector<protocol_t::id_t>&,
+            const std::vector<protocol_t::address_t>&, const std::vector<std::vector<uint8_t>>&)
+        {
+            throw errors::Error("BatchWrite: there is no bulk write in version 1 of the protocol");
+        }
+    };
+
+    template <>
+    struct BatchWriteInstructions<protocols::Protocol2> {
+        typedef protocols::Protocol2 protocol_t;
+
+        static const bool has_bulk_write = true;
+
+        static InstructionPacket<protocol_t> bulk_write(const std::vector<protocol_t::id_t>& ids,
+            const std::vector<protocol_t::address_t>& addresses, const std::vector<std::vector<uint8_t>>& data)
+        {
+            return instructions::BulkWrite<protocol_t>(ids, addresses, data);
+        }
+    };
+
+    /** Writes of several actuators, grouped into as few sync writes as
+        possible.
+
+        Each write gives the location of the field in the control table of the
+        actuator and the bytes to be written. The writes are grouped by address
+        and width: actuators of different models can share a sync write as long
+        as their fields are at the same place.
+
+            BatchWrite<Protocol1> batch;
+            for (auto servo : servos)
+                batch.add(servo->id(), servo->goal_position_field(),
+                    servo->goal_position_angle_data(angle));
+            batch.send(controller); // one packet per (address, width)
+
+        With protocol 2, the groups can also be combined into a single bulk
+        write (see `packets`).
+    **/
+    template <class Protocol>
+    class BatchWrite {
+    public:
+        typedef typename Protocol::id_t id_t;
+
+        /** Add the write of one actuator.
+
+            @param id identifier of the actuator
+            @param field location of the field in its control table
+            @param data bytes to be written, field.size of them
+            @throws errors::Error if data does not have the size of the field
+        **/
+        void add(id_t id, const Field<Protocol>& field, const std::vector<uint8_t>& data)
+        {
+            if (data.size() != field.size)
+                throw errors::Error("BatchWrite: the data does not have the size of the field");
+
+            _Group& group = _groups[std::make_pair((size_t)field.address, field.size)];
+            group.ids.push_back(id);
+            group.data.insert(group.data.end(), data.begin(), data.end());
+        }
+
+        bool empty() const { return _groups.empty(); }
+
+        void clear() { _groups.clear(); }
+
+        /// Number of (address, width) groups, i.e. of sync writes
+        size_t groups() const { return _groups.size(); }
+
+        /** Packets for all the writes.
+
+            @param bulk_write with protocol 2, combine the groups into a single
+                bulk write when there are several of them (and when no actuator
+                appears twice); ignored with protocol 1
+            @return one sync write for each (address, width) group, or the bulk
+                write
+        **/
+        std::vector<InstructionPacket<Protocol>> packets(bool bulk_write = false) const
+        {
+            std::vector<InstructionPacket<Protocol>> packets;
+            if (bulk_write && BatchWriteInstructions<Protocol>::has_bulk_write && _groups.size() > 1 && _unique_ids()) {
+                std::vector<id_t> ids;
+                std::vector<typename Protocol::address_t> addresses;
+                std::vector<std::vector<uint8_t>> data;
+                for (typename std::map<_key_t, _Group>::const_iterator it = _groups.begin(); it != _groups.end(); ++it) {
+                    const size_t size = it->first.second;
+                    for (size_t i = 0; i < it->second.ids.size(); ++i) {
+                        ids.push_back(it->second.ids[i]);
+                        addresses.push_back(it->first.first);
+                        data.push_back(std::vector<uint8_t>(it->second.data.begin() + i * size,
+                            it->second.data.begin() + (i + 1) * size));
+                    }
+                }
+                packets.push_back(BatchWriteInstructions<Protocol>::bulk_write(ids, addresses, data));
+                return packets;
+            }
+
+            for (typename std::map<_key_t, _Group>::const_iterator it = _groups.begin(); it != _groups.end(); ++it) {
+                instructions::SyncWriteBuilder<Protocol> builder;
+                builder.build(it->first.first, it->first.second, it->second.ids.data(),
+                    it->second.data.data(), it->first.second, it->second.ids.size());
+                packets.push_back(builder);
+            }
+            return packets;
+        }
+
+        /** Send the writes (no reply is expected), all the packets at once.
+
+            @param bulk_write @see packets
+            @return number of packets sent
+        **/
+        template <typename Controller>
+        size_t send(const Controller& controller, bool bulk_write = false) const
+        {
+            std::vector<InstructionPacket<Protocol>> all = packets(bulk_write);
+            SendQueue<Protocol> queue;
+            for (size_t i = 0; i < all.size(); ++i)
+                queue.push(all[i]);
+            return queue.flush(controller);
+        }
+
+    protected:
+        typedef std::pair<size_t, size_t> _key_t;
+
+        struct _Group {
+            std::vector<id_t> ids;
+            // data of all the actuators of the group, one after the other
+            std::vector<uint8_t> data;
+        };
+
+        // whether no actuator appears in two groups
+        bool _unique_ids() const
+        {
+            std::set<id_t> ids;
+            for (typename std::map<_key_t, _Group>::const_iterator it = _groups.begin(); it != _groups.end(); ++it)
+                for (size_t i = 0; i < it->second.ids.size(); ++i)
+                    if (!ids.insert(it->second.ids[i]).second)
+                        return false;
+            return true;
+        }
+
+        std::map<_key_t, _Group> _groups;
+    };
+
+    /** How the reads of a BatchRead are grouped into instructions; this depends
+        on the version of the protocol.
+    **/
+    template <class Protocol>
+    struct BatchReadInstructions;
+
+    /** Protocol 1 has no sync read: all the reads go in a bulk read, which may
+        mix fields of different addresses and widths.
+
+        The bulk read is only understood by the MX series (see
+        servos::BaseServo::supports_bulk_read); BatchRead reads the other
+        models individually.
+    **/
+    template <>
+    struct BatchReadInstructions<protocols::Protocol1> {
+        typedef protocols::Protocol1 protocol_t;
+
+        static bool same_instruction(const Field<protocol_t>&, const Field<protocol_t>&) { return true; }
+
+        static InstructionPacket<protocol_t> packet(const std::vector<protocol_t::id_t>& ids,
+            const std::vector<Field<protocol_t>>& fields)
+        {
+            std::vector<protocol_t::address_t> addresses(fields.size());
+            std::vector<uint8_t> lengths(fields.size());
+            for (size_t i = 0; i < fields.size(); ++i) {
+                addresses[i] = fields[i].address;
+                lengths[i] = fields[i].size;
+            }
+            return instructions::BulkRead<protocol_t>(addresses, ids, lengths);
+        }
+    };
+
+    /// Protocol 2: one sync read for each (address, width) group
+    template <>
+    struct BatchReadInstructions<protocols::Protocol2> {
+        typedef protocols::Protocol2 protocol_t;
+
+        static bool same_instruction(const Field<protocol_t>& a, const Field<protocol_t>& b)
+        {
+            return a.address == b.address && a.size == b.size;
+        }
+
+        static InstructionPacket<protocol_t> packet(const std::vector<protocol_t::id_t>& ids,
+            const std::vector<Field<protocol_t>>& fields)
+        {
+            return instructions::SyncRead<protocol_t>(fields.front().address, fields.front().size, ids);
+        }
+    };
+
+    /** Reads of several actuators, grouped into as few instructions as
+        possible: bulk reads for protocol 1, sync reads (one per address and
+        width) for protocol 2.
+
+        An actuator does not appear twice in the same instruction; the reads
+        are spread over several instructions if needed.
+
+        The actuators whose model does not understand these instructions (the
+        AX series, see servos::BaseServo::supports_bulk_read) are read one by
+        one, without waiting for a reply that will not come. The reads that
+        fail in the grouped instructions (for instance because a previous
+        actuator of a bulk read did not answer) are also done again one by
+        one.
+
+            BatchRead<Protocol2> batch;
+            for (auto servo : servos)
+                batch.add(servo->id(), servo->present_position_field(), servo->supports_bulk_read());
+            batch.read(controller, replies, statuses);
+            double angle = servos[i]->parse_present_position_angle(replies[i]);
+    **/
+    template <class Protocol>
+    class BatchRead {
+    public:
+        typedef typename Protocol::id_t id_t;
+
+        /** Add the read of one field of one actuator.
+
+            @param bulk whether the actuator answers the bulk and sync read
+                instructions; otherwise it is read individually
+            @return index of the read, in the replies and statuses
+        **/
+        size_t add(id_t id, const Field<Protocol>& field, bool bulk = true)
+        {
+            _ids.push_back(id);
+            _fields.push_back(field);
+            _bulk.push_back(bulk);
+            return _ids.size() - 1;
+        }
+
+        size_t size() const { return _ids.size(); }
+
+        void clear()
+        {
+            _ids.clear();
+            _fields.clear();
+            _bulk.clear();
+        }
+
+        /** Packets of the grouped instructions, and the reads of each one
+            (the individual reads are not included).
+
+            @param reads for each packet, indices of the reads (output)
+        **/
+        std::vector<InstructionPacket<Protocol>> packets(std::vector<std::vector<size_t>>& reads) const
+        {
+            reads.clear();
+            // ids already in each instruction
+            std::vector<std::set<id_t>> instruction_ids;
+
+            for (size_t i = 0; i < _ids.size(); ++i) {
+                if (!_bulk[i])
+                    continue;
+                size_t n = 0;
+                while (n < reads.size()
+                    && (!BatchReadInstructions<Protocol>::same_instruction(_fields[reads[n].front()], _fields[i])
+                        || instruction_ids[n].count(_ids[i])))
+                    ++n;
+                if (n == reads.size()) {
+                    reads.push_back(std::vector<size_t>());
+                    instruction_ids.push_back(std::set<id_t>());
+                }
+                reads[n].push_back(i);
+                instruction_ids[n].insert(_ids[i]);
+            }
+
+            std::vector<InstructionPacket<Protocol>> packets;
+            for (size_t n = 0; n < reads.size(); ++n) {
+                std::vector<id_t> ids;
+                std::vector<Field<Protocol>> fields;
+                for (size_t j = 0; j < reads[n].size(); ++j) {
+                    ids.push_back(_ids[reads[n][j]]);
+                    fields.push_back(_fields[reads[n][j]]);
+                }
+                packets.push_back(BatchReadInstructions<Protocol>::packet(ids, fields));
+            }
+            return packets;
+        }
+
+        /** Do all the reads.
+
+            No exception is thrown for errors that are specific to one actuator;
+            they are reported in statuses.
+
+            @param controller object handling the USB to dynamixel interface
+            @param replies status packet of each read, in the order of `add`;
+                the parameters hold the field (when the status is ok or
+                servo_error)
+            @param statuses status of each read
+        **/
+        template <typename Controller>
+        void read(const Controller& controller, std::vector<StatusPacket<Protocol>>& replies,
+            std::vector<ReadStatus>& statuses) const
+        {
+            replies.assign(_ids.size(), StatusPacket<Protocol>());
+            statuses.assign(_ids.size(), ReadStatus::timeout);
+
+            std::vector<std::vector<size_t>> reads;
+            std::vector<InstructionPacket<Protocol>> all = packets(reads);
+
+            for (size_t n = 0; n < all.size(); ++n) {
+                const std::vector<size_t>& indices = reads[n];
+                std::vector<id_t> ids;
+                for (size_t j = 0; j < indices.size(); ++j)
+                    ids.push_back(_ids[indices[j]]);
+
+                controller.send(all[n]);
+                recv_replies<Protocol>(controller, ids,
+                    [this, &indices, &replies, &statuses](size_t j, const StatusPacket<Protocol>& status) {
+                        _store(indices[j], status, replies, statuses);
+                    },
+                    [&indices, &statuses](size_t j, ReadStatus read_status) {
+                        statuses[indices[j]] = read_status;
+                    });
+            }
+
+            // individual reads, and fall back for the failed grouped ones
+            StatusPacket<Protocol> status;
+            protocols::DecodeReport report;
+            for (size_t i = 0; i < _ids.size(); ++i) {
+                if (statuses[i] == ReadStatus::ok || statuses[i] == ReadStatus::servo_error)
+                    continue;
+
+                controller.send(instructions::Read<Protocol>(_ids[i], _fields[i].address, _fields[i].size));
+                if (!controller.recv(status, report)) {
+                    statuses[i] = (report.error == protocols::DecodeError::checksum)
+                        ? ReadStatus::checksum_error
+                        : ReadStatus::timeout;
+                    continue;
+                }
+                if (status.id() != _ids[i]) {
+                    statuses[i] = ReadStatus::timeout;
+                    continue;
+                }
+                _store(i, status, replies, statuses);
+            }
+        }
+
+    protected:
+        void _store(size_t i, const StatusPacket<Protocol>& status,
+            std::vector<StatusPacket<Protocol>>& replies, std::vector<ReadStatus>& statuses) const
+        {
+            if (status.parameters().size() != _fields[i].size) {
+                statuses[i] = ReadStatus::size_mismatch;
+                return;
+            }
+            replies[i] = status;
+            statuses[i] = (0 == status.error_byte()) ? ReadStatus::ok : ReadStatus::servo_error;
+        }
+
+        std::vector<id_t> _ids;
+        std::vector<Field<Protocol>> _fields;
+        std::vector<bool> _bulk;
+    };
+} // namespace dynamixel
+
+#endif
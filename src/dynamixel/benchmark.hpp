@@ -0,0 +1,224 @@
+#ifndef DYNAMIXEL_BENCHMARK_HPP_
+#define DYNAMIXEL_BENCHMARK_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "batch.hpp"
+#include "instruction_packet.hpp"
+#include "protocols/decode_report.hpp"
+#include "read_result.hpp"
+#include "status_packet.hpp"
+
+namespace dynamixel {
+    /** Distribution of the durations of some operations on the bus.
+
+        The durations are in seconds; the failed operations are only counted.
+        The operations to which an actuator replied with an error (input
+        voltage, overheating...) completed, and are part of the distribution;
+        they are also counted apart.
+    **/
+    class LatencyStats {
+    public:
+        LatencyStats() : _failures(0), _servo_errors(0) {}
+
+        void add(double duration) { _durations.push_back(duration); }
+
+        /// Add an operation whose reply reported an error of the actuator
+        void add_servo_error(double duration)
+        {
+            add(duration);
+            ++_servo_errors;
+        }
+
+        void add_failure() { ++_failures; }
+
+        /// Number of completed operations
+        size_t count() const { return _durations.size(); }
+
+        size_t failures() const { return _failures; }
+
+        /// Number of completed operations whose reply reported an error
+        size_t servo_errors() const { return _servo_errors; }
+
+        double min() const
+        {
+            return _durations.empty() ? 0 : *std::min_element(_durations.begin(), _durations.end());
+        }
+
+        double max() const
+        {
+            return _durations.empty() ? 0 : *std::max_element(_durations.begin(), _durations.end());
+        }
+
+        double mean() const
+        {
+            double sum = 0;
+            for (size_t i = 0; i < _durations.size(); ++i)
+                sum += _durations[i];
+            return _durations.empty() ? 0 : sum / _durations.size();
+        }
+
+        /** Duration below which a given part of the operations completed.
+
+            @param p part of the operations, in [0, 1] (0.5 for the median)
+        **/
+        double percentile(double p) const
+        {
+            if (_durations.empty())
+                return 0;
+            std::vector<double> sorted(_durations);
+            std::sort(sorted.begin(), sorted.end());
+            size_t rank = (size_t)(p * (sorted.size() - 1) + 0.5);
+            return sorted[std::min(rank, sorted.size() - 1)];
+        }
+
+        /** Number of durations in each of n_buckets buckets of equal width,
+            from min() to max().
+        **/
+        std::vector<size_t> histogram(size_t n_buckets) const
+        {
+            std::vector<size_t> counts(n_buckets, 0);
+            double low = min(), width = (max() - low) / n_buckets;
+            for (size_t i = 0; i < _durations.size() && n_buckets > 0; ++i) {
+                size_t bucket = (width > 0) ? (size_t)((_durations[i] - low) / width) : 0;
+                ++counts[std::min(bucket, n_buckets - 1)];
+            }
+            return counts;
+        }
+
+        /** Write a summary (in milliseconds) and a text histogram.
+
+            @param out output stream
+            @param n_buckets number of lines of the histogram
+            @param width number of characters of the longest bar
+        **/
+        void print(std::ostream& out, size_t n_buckets = 10, size_t width = 40) const
+        {
+            out << std::fixed << std::setprecision(3)
+                << "  " << count() << " ok, " << failures() << " failed";
+            if (_servo_errors > 0)
+                out << " (" << _servo_errors << " ok with an actuator error)";
+            if (_durations.empty()) {
+                out << std::endl;
+                return;
+            }
+            out << "; min " << 1e3 * min() << " ms, mean " << 1e3 * mean()
+                << " ms, median " << 1e3 * percentile(0.5) << " ms, 99% "
+                << 1e3 * percentile(0.99) << " ms, max " << 1e3 * max() << " ms"
+                << std::endl;
+
+            std::vector<size_t> counts = histogram(n_buckets);
+            size_t highest = *std::max_element(counts.begin(), counts.end());
+            double bucket_width = (max() - min()) / n_buckets;
+            for (size_t i = 0; i < counts.size(); ++i) {
+                out << "  " << std::setw(9) << 1e3 * (min() + i * bucket_width) << " ms |"
+                    << std::string(highest ? counts[i] * width / highest : 0, '#')
+                    << " " << counts[i] << std::endl;
+                // all the durations are the same
+                if (bucket_width <= 0)
+                    break;
+            }
+        }
+
+    protected:
+        std::vector<double> _durations;
+        size_t _failures;
+        size_t _servo_errors;
+    };
+
+    /** Time n transactions made of an instruction and the status packet of
+        the actuator it targets (ping, read, write...).
+
+        A transaction fails when no valid status packet comes back from this
+        actuator; it is then not part of the distribution. A status packet
+        reporting an error of the actuator completes the transaction (see
+        LatencyStats::servo_errors).
+
+        @param controller object handling the USB to dynamixel interface
+        @param id identifier of the actuator targeted by the instruction
+        @param packet instruction sent
+        @param n number of transactions
+        @return distribution of the round-trip times
+    **/
+    template <class Protocol, typename Controller>
+    LatencyStats bench_transactions(const Controller& controller, typename Protocol::id_t id,
+        const InstructionPacket<Protocol>& packet, size_t n)
+    {
+        typedef std::chrono::steady_clock clock_t;
+        LatencyStats stats;
+        StatusPacket<Protocol> status;
+        protocols::DecodeReport report;
+
+        for (size_t i = 0; i < n; ++i) {
+            clock_t::time_point start = clock_t::now();
+            controller.send(packet);
+            bool ok = controller.recv(status, report) && status.id() == id;
+            clock_t::duration duration = clock_t::now() - start;
+
+            double seconds = std::chrono::duration_cast<std::chrono::duration<double>>(duration).count();
+            if (!ok)
+                stats.add_failure();
+            else if (0 != status.error_byte())
+                stats.add_servo_error(seconds);
+            else
+                stats.add(seconds);
+        }
+
+        return stats;
+    }
+
+    /** Time n control cycles, each one made of batched writes followed by
+        batched reads (as in a control loop).
+
+        A cycle fails when some read does not succeed. The inverse of the mean
+        duration is the loop rate that can be achieved on this bus.
+
+        @param controller object handling the USB to dynamixel interface
+        @param writes writes of each cycle (may be empty)
+        @param reads reads of each cycle (may be empty)
+        @param n number of cycles
+        @param bulk_write @see BatchWrite::packets
+        @return distribution of the cycle times
+    **/
+    template <class Protocol, typename Controller>
+    LatencyStats bench_cycles(const Controller& controller, const BatchWrite<Protocol>& writes,
+        const BatchRead<Protocol>& reads, size_t n, bool bulk_write = false)
+    {
+        typedef std::chrono::steady_clock clock_t;
+        LatencyStats stats;
+        std::vector<StatusPacket<Protocol>> replies;
+        std::vector<ReadStatus> statuses;
+
+        for (size_t i = 0; i < n; ++i) {
+            clock_t::time_point start = clock_t::now();
+            if (!writes.empty())
+                writes.send(controller, bulk_write);
+            if (reads.size() > 0)
+                reads.read(controller, replies, statuses);
+            clock_t::duration duration = clock_t::now() - start;
+
+            bool ok = true, servo_error = false;
+            for (size_t j = 0; j < statuses.size(); ++j) {
+                ok = ok && (ReadStatus::ok == statuses[j] || ReadStatus::servo_error == statuses[j]);
+                servo_error = servo_error || ReadStatus::servo_error == statuses[j];
+            }
+            double seconds = std::chrono::duration_cast<std::chrono::duration<double>>(duration).count();
+            if (!ok)
+                stats.add_failure();
+            else if (servo_error)
+                stats.add_servo_error(seconds);
+            else
+                stats.add(seconds);
+        }
+
+        return stats;
+    }
+} // namespace dynamixel
+
+#endif
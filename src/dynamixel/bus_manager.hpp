@@ -0,0 +1,270 @@
+#ifndef DYNAMIXEL_BUS_MANAGER_HPP_
+#define DYNAMIXEL_BUS_MANAGER_HPP_
+
+#include <stdint.h>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "auto_detect.hpp"
+#include "batch.hpp"
+#include "controllers/usb2dynamixel.hpp"
+#include "errors/error.hpp"
+#include "read_plan.hpp"
+#include "read_result.hpp"
+#include "servos/base_servo.hpp"
+#include "status_packet.hpp"
+
+namespace dynamixel {
+    /** Global identifier of an actuator, among several buses: the index of
+        its bus in a BusManager and its id on this bus.
+    **/
+    template <class Protocol>
+    struct BusId {
+        size_t bus;
+        typename Protocol::id_t id;
+
+        bool operator<(const BusId& other) const
+        {
+            return bus < other.bus || (bus == other.bus && id < other.id);
+        }
+
+        bool operator==(const BusId& other) const
+        {
+            return bus == other.bus && id == other.id;
+        }
+    };
+
+    /** Several buses (for instance, one per USB to dynamixel interface),
+        each one serviced by its own thread.
+
+        The exchanges of all the buses of a cycle run in parallel, so the
+        duration of a cycle is the one of the slowest bus instead of the sum
+        of all of them. `cycle` is a barrier: it returns once every bus is
+        done.
+
+            BusManager<Protocol1> buses;
+            buses.add_bus("/dev/ttyUSB0", B1000000, 0.02);
+            buses.add_bus("/dev/ttyUSB1", B1000000, 0.02);
+
+            std::vector<BusId<Protocol1>> legs = {{0, 1}, {0, 2}, {1, 1}, {1, 2}};
+            std::vector<Field<Protocol1>> fields(legs.size(), Mx28::field_present_position());
+            buses.read(legs, fields, replies, statuses); // both buses at once
+
+        Each bus is only used by its own thread while a cycle runs; between
+        the cycles, the controllers can be used directly (see `controller`).
+        The library has to be linked with the thread library (-pthread).
+    **/
+    template <class Protocol, class Controller = controllers::Usb2Dynamixel>
+    class BusManager {
+    public:
+        typedef typename Protocol::id_t id_t;
+        typedef BusId<Protocol> bus_id_t;
+        /// Exchange of one cycle, called as exchange(bus index, controller)
+        typedef std::function<void(size_t, const Controller&)> exchange_t;
+
+        BusManager() : _generation(0), _pending(0), _stop(false) {}
+
+        ~BusManager()
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stop = true;
+            }
+            _start.notify_all();
+            for (size_t i = 0; i < _buses.size(); ++i)
+                _buses[i]->thread.join();
+        }
+
+        /** Add a bus, and start its thread.
+
+            @param args arguments of the constructor of the controller (for
+                instance the name of the port, the baudrate and the timeout)
+            @return index of the new bus
+        **/
+        template <typename... Args>
+        size_t add_bus(Args&&... args)
+        {
+            std::lock_guard<std::mutex> cycle_lock(_cycle_mutex);
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            size_t index = _buses.size();
+            std::unique_ptr<_Bus> bus(new _Bus);
+            bus->controller.reset(new Controller(std::forward<Args>(args)...));
+            bus->thread = std::thread(&BusManager::_work, this, index, bus->controller.get(), _generation);
+            _buses.push_back(std::move(bus));
+
+            return index;
+        }
+
+        size_t size() const { return _buses.size(); }
+
+        /// Controller of a bus; only use it outside of the cycles
+        Controller& controller(size_t bus) { return *_buses.at(bus)->controller; }
+
+        /** Run an exchange on all the buses in parallel, and wait until all of
+            them are done.
+
+            @param exchange called once per bus, from the thread of this bus
+            @throws the first exception thrown by an exchange (once all the
+                buses are done)
+        **/
+        void cycle(const exchange_t& exchange)
+        {
+            std::lock_guard<std::mutex> cycle_lock(_cycle_mutex);
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            _exchange = exchange;
+            _errors.assign(_buses.size(), std::exception_ptr());
+            _pending = _buses.size();
+            ++_generation;
+            _start.notify_all();
+            _done.wait(lock, [this]() { return 0 == _pending; });
+            _exchange = exchange_t();
+
+            for (size_t i = 0; i < _errors.size(); ++i)
+                if (_errors[i])
+                    std::rethrow_exception(_errors[i]);
+        }
+
+        /** Detect the actuators of all the buses, in parallel.
+
+            @param ids ids searched for on each bus
+            @return the actuators found, by global id
+        **/
+        std::map<bus_id_t, std::shared_ptr<servos::BaseServo<Protocol>>>
+        detect_servos(const std::vector<id_t>& ids)
+        {
+            std::vector<std::map<id_t, std::shared_ptr<servos::BaseServo<Protocol>>>> found(_buses.size());
+            cycle([&found, &ids](size_t bus, const Controller& controller) {
+                found[bus] = auto_detect_map<Protocol>(controller, ids);
+            });
+
+            std::map<bus_id_t, std::shared_ptr<servos::BaseServo<Protocol>>> servos;
+            for (size_t bus = 0; bus < found.size(); ++bus)
+                for (auto servo : found[bus]) {
+                    bus_id_t id = {bus, servo.first};
+                    servos[id] = servo.second;
+                }
+            return servos;
+        }
+
+        /** Read some fields of actuators spread on several buses, in one
+            cycle (with a BatchRead per bus).
+
+            @param ids global ids of the actuators
+            @param fields field read for each actuator
+            @param replies status packet of each read, in the order of ids
+            @param statuses status of each read
+        **/
+        void read(const std::vector<bus_id_t>& ids, const std::vector<Field<Protocol>>& fields,
+            std::vector<StatusPacket<Protocol>>& replies, std::vector<ReadStatus>& statuses)
+        {
+            if (ids.size() != fields.size())
+                throw errors::Error("BusManager::read: mismatching vectors size for ids and fields");
+
+            std::vector<BatchRead<Protocol>> reads(_buses.size());
+            // position in ids of each read of each bus
+            std::vector<std::vector<size_t>> indices(_buses.size());
+            for (size_t i = 0; i < ids.size(); ++i) {
+                reads.at(ids[i].bus).add(ids[i].id, fields[i]);
+                indices[ids[i].bus].push_back(i);
+            }
+
+            std::vector<std::vector<StatusPacket<Protocol>>> bus_replies(_buses.size());
+            std::vector<std::vector<ReadStatus>> bus_statuses(_buses.size());
+            cycle([&](size_t bus, const Controller& controller) {
+                if (reads[bus].size() > 0)
+                    reads[bus].read(controller, bus_replies[bus], bus_statuses[bus]);
+            });
+
+            replies.assign(ids.size(), StatusPacket<Protocol>());
+            statuses.assign(ids.size(), ReadStatus::timeout);
+            for (size_t bus = 0; bus < indices.size(); ++bus)
+                for (size_t j = 0; j < indices[bus].size(); ++j) {
+                    replies[indices[bus][j]] = bus_replies[bus][j];
+                    statuses[indices[bus][j]] = bus_statuses[bus][j];
+                }
+        }
+
+        /** Write some fields of actuators spread on several buses, in one
+            cycle (with a BatchWrite per bus; no reply is expected).
+
+            @param ids global ids of the actuators
+            @param fields field written for each actuator
+            @param data value of each field, already encoded
+        **/
+        void write(const std::vector<bus_id_t>& ids, const std::vector<Field<Protocol>>& fields,
+            const std::vector<std::vector<uint8_t>>& data)
+        {
+            if (ids.size() != fields.size() || ids.size() != data.size())
+                throw errors::Error("BusManager::write: mismatching vectors size for ids, fields and data");
+
+            std::vector<BatchWrite<Protocol>> writes(_buses.size());
+            for (size_t i = 0; i < ids.size(); ++i)
+                writes.at(ids[i].bus).add(ids[i].id, fields[i], data[i]);
+
+            cycle([&writes](size_t bus, const Controller& controller) {
+                if (!writes[bus].empty())
+                    writes[bus].send(controller, true);
+            });
+        }
+
+    protected:
+        struct _Bus {
+            std::unique_ptr<Controller> controller;
+            std::thread thread;
+        };
+
+        // loop of the thread of a bus: run the exchange of each new cycle
+        void _work(size_t index, const Controller* controller, size_t generation)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (true) {
+                _start.wait(lock, [this, generation]() { return _stop || _generation != generation; });
+                if (_stop)
+                    return;
+                generation = _generation;
+                exchange_t exchange = _exchange;
+                lock.unlock();
+
+                try {
+                    exchange(index, *controller);
+                }
+                catch (...) {
+                    lock.lock();
+                    _errors[index] = std::current_exception();
+                    lock.unlock();
+                }
+
+                lock.lock();
+                if (0 == --_pending)
+                    _done.notify_all();
+            }
+        }
+
+        std::vector<std::unique_ptr<_Bus>> _buses;
+
+        // serializes the cycles (and the addition of buses)
+        std::mutex _cycle_mutex;
+        // protects the state below, shared with the threads of the buses
+        std::mutex _mutex;
+        std::condition_variable _start;
+        std::condition_variable _done;
+        exchange_t _exchange;
+        std::vector<std::exception_ptr> _errors;
+        // incremented at the start of each cycle
+        size_t _generation;
+        // number of buses still busy with the current cycle
+        size_t _pending;
+        bool _stop;
+    };
+} // namespace dynamixel
+
+#endif
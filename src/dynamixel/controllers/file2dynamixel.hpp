@@ -5,6 +5,7 @@
 #include <errno.h>
 #include <termios.h>
 #include <vector>
+#include <array>
 #include <cstdio>
 #include <stdint.h>
 #include <unistd.h>
@@ -75,6 +76,9 @@ namespace dynamixel {
 
             bool is_open() { return !(_fd == -1); }
 
+            /// File descriptor of the file, for event loops (see AsyncBus)
+            int fd() const { return _fd; }
+
             off_t seek(unsigned int offset)
             {
                 return lseek(_fd, (off_t)offset, SEEK_SET);
@@ -84,41 +88,39 @@ namespace dynamixel {
             template <typename T>
             void send(const InstructionPacket<T>& packet) const
             {
-                if (_fd == -1)
-                    return;
-
-                int ret = write(_fd, packet.data(), packet.size());
-
-                std::cout << "Send: ";
-                for (size_t i = 0; i < packet.size(); ++i)
-                    std::cout << "0x" << std::setfill('0') << std::setw(2) << std::hex << (unsigned int)packet[i] << " ";
-                std::cout << std::endl;
+                send(packet.data(), packet.size());
+            }
 
-                if (ret != packet.size()) {
-                    std::stringstream ofs;
-                    perror("write:");
-                    ofs << "written= " << ret << ", size=" << packet.size();
-                    throw errors::Error("File2Dynamixel::Send: packet not fully written " + ofs.str());
-                }
+            // send a packet built at compile time (see instructions::StaticPackets)
+            template <size_t N>
+            void send(const std::array<uint8_t, N>& packet) const
+            {
+                send(packet.data(), N);
             }
 
             // generic send
             void send(const std::vector<uint8_t>& packet) const
+            {
+                send(&packet.front(), packet.size());
+            }
+
+            // send raw bytes
+            void send(const uint8_t* packet, size_t size) const
             {
                 if (_fd == -1)
                     return;
 
-                int ret = write(_fd, &packet.front(), packet.size());
+                int ret = write(_fd, packet, size);
 
                 std::cout << "Send: ";
-                for (size_t i = 0; i < packet.size(); ++i)
+                for (size_t i = 0; i < size; ++i)
                     std::cout << "0x" << std::setfill('0') << std::setw(2) << std::hex << (unsigned int)packet[i] << " ";
                 std::cout << std::endl;
 
-                if (ret != packet.size()) {
+                if (ret != size) {
                     std::stringstream ofs;
                     perror("write:");
-                    ofs << "written= " << ret << ", size=" << packet.size();
+                    ofs << "written= " << ret << ", size=" << size;
                     throw errors::Error("File2Dynamixel::Send: packet not fully written " + ofs.str());
                 }
             }
@@ -187,6 +189,53 @@ namespace dynamixel {
                 return true;
             }
 
+            /** Receive a status packet without throwing exceptions.
+
+                @see Usb2Dynamixel::recv(StatusPacket<T>&, protocols::DecodeReport&)
+            **/
+            template <typename T>
+            bool recv(StatusPacket<T>& status, protocols::DecodeReport& report) const
+            {
+                using DecodeState = typename T::DecodeState;
+
+                report.clear();
+                if (_fd == -1)
+                    return false;
+
+                int res = 0;
+                DecodeState state = DecodeState::ONGOING;
+                protocols::DecodeReport rejected;
+
+                std::vector<uint8_t> packet;
+                packet.reserve(_recv_buffer_size);
+
+                do {
+                    uint8_t byte;
+                    res = read(_fd, &byte, 1);
+
+                    if (res > 0) {
+                        packet.push_back(byte);
+
+                        state = status.decode_packet(packet, report);
+                        if (state == DecodeState::INVALID) {
+                            if (report.error == protocols::DecodeError::checksum) {
+                                rejected = report;
+                                rejected.discarded_checksum = true;
+                            }
+                            packet.clear();
+                        }
+                    }
+                } while (state != DecodeState::DONE && res);
+
+                if (state != DecodeState::DONE) {
+                    report = rejected;
+                    return false;
+                }
+
+                report.discarded_checksum = rejected.discarded_checksum;
+                return true;
+            }
+
             void set_report_bad_packet(bool report_bad_packet)
             {
                 _report_bad_packet = report_bad_packet;
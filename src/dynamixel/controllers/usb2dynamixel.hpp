@@ -1,6 +1,7 @@
 #ifndef DYNAMIXEL_CONTROLLERS_USB2DYNAMIXEL_HPP_
 #define DYNAMIXEL_CONTROLLERS_USB2DYNAMIXEL_HPP_
 
+#include <array>
 #include <cstdio>
 #include <cstring>
 #include <errno.h>
@@ -132,6 +133,9 @@ namespace dynamixel {
 
             bool is_open() { return !(_fd == -1); }
 
+            /// File descriptor of the serial port, for event loops (see AsyncBus)
+            int fd() const { return _fd; }
+
             void flush() { tcflush(_fd, TCIFLUSH); }
 
             double recv_timeout() { return _recv_timeout; }
@@ -141,24 +145,37 @@ namespace dynamixel {
             // general send
             template <typename T>
             void send(const InstructionPacket<T>& packet) const
+            {
+                send(packet.data(), packet.size());
+            }
+
+            // send a packet built at compile time (see instructions::StaticPackets)
+            template <size_t N>
+            void send(const std::array<uint8_t, N>& packet) const
+            {
+                send(packet.data(), N);
+            }
+
+            // send raw bytes
+            void send(const uint8_t* packet, size_t size) const
             {
                 if (_fd == -1)
                     return;
 
-                const int ret = write(_fd, packet.data(), packet.size());
+                const int ret = write(_fd, packet, size);
 
                 // std::cout << "Send: ";
-                // for (size_t i = 0; i < packet.size(); ++i)
+                // for (size_t i = 0; i < size; ++i)
                 //     std::cout << "0x" << std::setfill('0') << std::setw(2) << std::hex << (unsigned int)packet[i] << " ";
                 // std::cout << std::endl;
 
                 if (ret == -1) {
                     throw errors::Error("Usb2Dynamixel::Send write error " + write_error_string(errno));
                 }
-                else if (ret != packet.size()) {
+                else if (ret != size) {
                     std::stringstream ofs;
                     perror("write:");
-                    ofs << "written= " << ret << " size=" << packet.size();
+                    ofs << "written= " << ret << " size=" << size;
                     throw errors::Error("Usb2Dynamixel::Send: packet not fully written " + ofs.str());
                 }
             }
@@ -212,6 +229,67 @@ namespace dynamixel {
                 return true;
             }
 
+            /** Receive a status packet without throwing exceptions.
+
+                A packet in which the actuator flagged an error is accepted (the
+                method returns true) and the error is given in
+                report.error_byte, with report.error set to
+                protocols::DecodeError::servo_error.
+
+                @param status status packet, filled if one is received
+                @param report on success, tells whether the actuator reported an
+                    error; on failure, report.error is
+                    protocols::DecodeError::checksum if a packet was discarded
+                    because of a checksum mismatch; in both cases,
+                    report.discarded_checksum tells whether such a packet was
+                    discarded during the call
+                @return false if no valid packet was received before the timeout
+            **/
+            template <typename T>
+            bool recv(StatusPacket<T>& status, protocols::DecodeReport& report) const
+            {
+                using DecodeState = typename T::DecodeState;
+
+                report.clear();
+                if (_fd == -1)
+                    return false;
+
+                double time = get_time();
+                DecodeState state = DecodeState::ONGOING;
+                protocols::DecodeReport rejected;
+
+                std::vector<uint8_t> packet;
+                packet.reserve(_recv_buffer_size);
+
+                do {
+                    double current_time = get_time();
+                    uint8_t byte;
+                    int res = read(_fd, &byte, 1);
+                    if (res > 0) {
+                        packet.push_back(byte);
+
+                        state = status.decode_packet(packet, report);
+                        if (state == DecodeState::INVALID) {
+                            if (report.error == protocols::DecodeError::checksum) {
+                                rejected = report;
+                                rejected.discarded_checksum = true;
+                            }
+                            packet.clear();
+                        }
+
+                        time = current_time;
+                    }
+
+                    if (current_time - time > _recv_timeout) {
+                        report = rejected;
+                        return false;
+                    }
+                } while (state != DecodeState::DONE);
+
+                report.discarded_checksum = rejected.discarded_checksum;
+                return true;
+            }
+
             /** Enable error reporting for packet issues
 
                 If report_bad_packet is set to true, invalid packet headers and
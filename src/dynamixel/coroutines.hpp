@@ -0,0 +1,240 @@
+#ifndef DYNAMIXEL_COROUTINES_HPP_
+#define DYNAMIXEL_COROUTINES_HPP_
+
+#if __cplusplus < 202002L || !defined(__cpp_impl_coroutine)
+#error "dynamixel/coroutines.hpp requires C++20 coroutines (configure with --cxx20)"
+#endif
+
+#include <stdint.h>
+#include <coroutine>
+#include <exception>
+#include <poll.h>
+#include <utility>
+#include <vector>
+
+#include "async_bus.hpp"
+#include "instruction_packet.hpp"
+#include "instructions/ping.hpp"
+#include "instructions/read.hpp"
+#include "instructions/write.hpp"
+#include "read_plan.hpp"
+#include "read_result.hpp"
+
+namespace dynamixel {
+    /** Coroutine running a sequence of transactions on a CoroutineBus (for
+        instance a homing or a calibration procedure).
+
+        The coroutine starts as soon as it is called, and runs until its first
+        `co_await`; it is then resumed by the bus when the reply arrives. An
+        exception thrown by the coroutine is kept, and rethrown by `get`.
+    **/
+    class BusTask {
+    public:
+        struct promise_type {
+            BusTask get_return_object()
+            {
+                return BusTask(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_never initial_suspend() noexcept { return {}; }
+
+            // keep the frame, so that done() can still be called
+            std::suspend_always final_suspend() noexcept { return {}; }
+
+            void return_void() {}
+
+            void unhandled_exception() { exception = std::current_exception(); }
+
+            std::exception_ptr exception;
+        };
+
+        BusTask(BusTask&& other) noexcept : _handle(std::exchange(other._handle, nullptr)) {}
+
+        BusTask& operator=(BusTask&& other) noexcept
+        {
+            if (this != &other) {
+                if (_handle)
+                    _handle.destroy();
+                _handle = std::exchange(other._handle, nullptr);
+            }
+            return *this;
+        }
+
+        BusTask(const BusTask&) = delete;
+        BusTask& operator=(const BusTask&) = delete;
+
+        ~BusTask()
+        {
+            if (_handle)
+                _handle.destroy();
+        }
+
+        /// Whether the coroutine returned (or threw)
+        bool done() const { return !_handle || _handle.done(); }
+
+        /// Rethrow the exception thrown by the coroutine, if any
+        void get() const
+        {
+            if (_handle && _handle.promise().exception)
+                std::rethrow_exception(_handle.promise().exception);
+        }
+
+    private:
+        explicit BusTask(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+
+        std::coroutine_handle<promise_type> _handle;
+    };
+
+    /** Bus whose transactions are awaited by coroutines; it is an AsyncBus
+        (@see AsyncBus), so many coroutines share it and their transactions
+        are executed one after the other, in the order they were awaited.
+
+            BusTask homing(CoroutineBus<Protocol1>& bus, Protocol1::id_t id)
+            {
+                co_await bus.write(id, Mx28::field_torque_enable(), (uint8_t)1);
+                auto position = co_await bus.read<uint16_t>(id, Mx28::field_present_position());
+                ...
+            }
+
+            CoroutineBus<Protocol1> bus(controller);
+            BusTask first = homing(bus, 1), second = homing(bus, 2);
+            while (!first.done() || !second.done()) {
+                bus.poll(); // never blocks: call it from the control loop
+                ...
+            }
+
+        The coroutines are resumed from `poll` (or `run`), in the thread that
+        drives the bus.
+    **/
+    template <class Protocol, class Controller = controllers::Usb2Dynamixel>
+    class CoroutineBus {
+    public:
+        typedef typename Protocol::id_t id_t;
+
+        /// Awaitable transaction, giving an AsyncResult
+        class Transaction {
+        public:
+            Transaction(AsyncBus<Protocol, Controller>& bus, const InstructionPacket<Protocol>& packet,
+                bool reply, id_t reply_id)
+                : _bus(bus), _packet(packet), _reply(reply), _reply_id(reply_id) {}
+
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                auto resume = [this, handle](const AsyncResult<Protocol>& result) {
+                    _result = result;
+                    handle.resume();
+                };
+                if (_reply)
+                    _bus.submit(_packet, _reply_id, resume);
+                else
+                    _bus.submit(_packet, resume);
+            }
+
+            AsyncResult<Protocol> await_resume() const { return _result; }
+
+        protected:
+            AsyncBus<Protocol, Controller>& _bus;
+            InstructionPacket<Protocol> _packet;
+            bool _reply;
+            id_t _reply_id;
+            AsyncResult<Protocol> _result;
+        };
+
+        /// Awaitable read of a field, giving a ReadResult
+        template <typename T>
+        class Read : public Transaction {
+        public:
+            Read(AsyncBus<Protocol, Controller>& bus, id_t id, const Field<Protocol>& field)
+                : Transaction(bus, instructions::Read<Protocol>(id, field.address, field.size), true, id) {}
+
+            ReadResult<Protocol, T> await_resume() const
+            {
+                ReadResult<Protocol, T> result(this->_reply_id);
+                result.status = this->_result.status;
+                if (result.has_value())
+                    parse_result(this->_result.reply, result);
+                return result;
+            }
+        };
+
+        /** @param controller object handling the USB to dynamixel interface
+            @param recv_timeout @see AsyncBus
+        **/
+        CoroutineBus(const Controller& controller, double recv_timeout = 0.02)
+            : _bus(controller, recv_timeout) {}
+
+        /// The underlying asynchronous bus, to plug its fd in an event loop
+        AsyncBus<Protocol, Controller>& async() { return _bus; }
+
+        /// co_await the reply of actuator reply_id to an instruction
+        Transaction transaction(const InstructionPacket<Protocol>& packet, id_t reply_id)
+        {
+            return Transaction(_bus, packet, true, reply_id);
+        }
+
+        /// co_await the sending of an instruction to which nobody replies
+        Transaction transaction(const InstructionPacket<Protocol>& packet)
+        {
+            return Transaction(_bus, packet, false, 0);
+        }
+
+        Transaction ping(id_t id)
+        {
+            return transaction(instructions::Ping<Protocol>(id), id);
+        }
+
+        /// co_await the value of a field; sizeof(T) must match its size
+        template <typename T>
+        Read<T> read(id_t id, const Field<Protocol>& field)
+        {
+            if (sizeof(T) != field.size)
+                throw errors::Error("CoroutineBus: the value does not have the size of the field");
+            return Read<T>(_bus, id, field);
+        }
+
+        /** co_await the write of a field; sizeof(T) must match its size. The
+            actuator's reply is awaited, except for the broadcast id.
+        **/
+        template <typename T>
+        Transaction write(id_t id, const Field<Protocol>& field, T value)
+        {
+            if (sizeof(T) != field.size)
+                throw errors::Error("CoroutineBus: the value does not have the size of the field");
+            std::vector<uint8_t> data(sizeof(T));
+            Protocol::pack_data(value, data.data());
+            instructions::Write<Protocol> packet(id, field.address, data);
+            return (Protocol::broadcast_id == id) ? transaction(packet) : transaction(packet, id);
+        }
+
+        /** Handle the events of the bus without blocking longer than
+            timeout_ms (0: never block), resuming the coroutines whose
+            transaction completed.
+        **/
+        void poll(int timeout_ms = 0)
+        {
+            // -1 means no timeout, for both
+            int timeout = _bus.timeout_ms();
+            if (timeout < 0 || (timeout_ms >= 0 && timeout_ms < timeout))
+                timeout = timeout_ms;
+            struct pollfd descriptor = {_bus.fd(), POLLIN, 0};
+            if (::poll(&descriptor, 1, timeout) > 0)
+                _bus.on_readable();
+            _bus.process();
+        }
+
+        /// Drive the bus until the task is done, and rethrow its exception
+        void run(const BusTask& task)
+        {
+            while (!task.done())
+                poll(_bus.pending() > 0 ? _bus.timeout_ms() : 0);
+            task.get();
+        }
+
+    protected:
+        AsyncBus<Protocol, Controller> _bus;
+    };
+} // namespace dynamixel
+
+#endif
@@ -3,6 +3,7 @@
 
 #include "dynamixel_core.hpp"
 #include "servos.hpp"
+#include "indirect_mapping.hpp"
 #include "auto_detect.hpp"
 #include "operating_mode.hpp"
 
@@ -3,6 +3,16 @@
 
 #include "instruction_packet.hpp"
 #include "status_packet.hpp"
+#include "read_result.hpp"
+#include "read_plan.hpp"
+#include "joint_states.hpp"
+#include "send_queue.hpp"
+#include "pipeline.hpp"
+#include "shadow_table.hpp"
+#include "eeprom_cache.hpp"
+#include "batch.hpp"
+#include "benchmark.hpp"
+#include "monitor.hpp"
 #include "controllers.hpp"
 #include "protocols.hpp"
 #include "errors.hpp"
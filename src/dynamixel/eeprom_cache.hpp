@@ -0,0 +1,219 @@
+#ifndef DYNAMIXEL_EEPROM_CACHE_HPP_
+#define DYNAMIXEL_EEPROM_CACHE_HPP_
+
+#include <stdint.h>
+#include <cstddef>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#include "errors/error.hpp"
+#include "instructions/read.hpp"
+#include "read_plan.hpp"
+#include "status_packet.hpp"
+
+namespace dynamixel {
+    /** Host copy of the EEPROM area of several actuators.
+
+        The fields of the EEPROM area (model number, firmware version,
+        baudrate, return delay time, angle or position limits, operating
+        mode...) only change when they are written, so there is no need to
+        read them again each time they are used. The first time a field of an
+        actuator is requested, the whole EEPROM area of this actuator is read
+        with a single Read instruction; the following requests are served from
+        the cache.
+
+            EepromCache<Protocol1> eeprom;
+            uint16_t cw = eeprom.get<uint16_t>(controller, id, Mx28::ct_t::cw_angle_limit);
+            uint16_t ccw = eeprom.get<uint16_t>(controller, id, Mx28::ct_t::ccw_angle_limit);
+            // only one packet was sent
+
+        The size of the EEPROM area depends on the model: it is given per
+        actuator with `set_size` (see servos::BaseServo::eeprom_size), and is
+        otherwise default_size(), which all the models of the protocol have.
+
+        The cache is not aware of the packets that are sent without it: after
+        writing in the EEPROM area of an actuator (or after a factory reset),
+        call `invalidate` so that it is read again on next use. The writes
+        done by dynamixel::Utility already do it.
+    **/
+    template <class Protocol>
+    class EepromCache {
+    public:
+        typedef typename Protocol::id_t id_t;
+        typedef typename Protocol::address_t address_t;
+
+        /** Number of bytes of the EEPROM area that all the models using
+            Protocol have (the XL-320 has the smallest one of protocol 2)
+        **/
+        static constexpr size_t default_size()
+        {
+            return 24;
+        }
+
+        /** @param size number of bytes cached for the actuators whose size was
+                not set, from address 0
+        **/
+        explicit EepromCache(size_t size = default_size()) : _size(size) {}
+
+        /// Number of bytes cached for the actuators whose size was not set
+        size_t size() const { return _size; }
+
+        /// Number of bytes cached for an actuator
+        size_t size(id_t id) const
+        {
+            typename std::map<id_t, size_t>::const_iterator it = _sizes.find(id);
+            return (it == _sizes.end()) ? _size : it->second;
+        }
+
+        /** Set the number of bytes cached for an actuator, usually the size of
+            the EEPROM area of its model (servos::BaseServo::eeprom_size). It
+            is kept when the actuator is invalidated.
+        **/
+        void set_size(id_t id, size_t size)
+        {
+            _sizes[id] = size;
+            if (cached(id) && _data[id].size() > size)
+                _data.erase(id);
+        }
+
+        /// Whether the EEPROM area of an actuator is in the cache
+        bool cached(id_t id) const
+        {
+            return _data.find(id) != _data.end();
+        }
+
+        /** Read the EEPROM area of an actuator, even if it is already cached.
+
+            @param controller object handling the USB to dynamixel interface
+            @param id identifier of the actuator
+            @throws errors::Error if the actuator does not answer with the
+                expected amount of data
+        **/
+        template <typename Controller>
+        void load(const Controller& controller, id_t id)
+        {
+            const size_t size = this->size(id);
+            controller.send(instructions::Read<Protocol>(id, 0, size));
+
+            StatusPacket<Protocol> status;
+            if (!controller.recv(status) || status.id() != id) {
+                std::stringstream message;
+                message << "No viable response from the actuator " << (int)id
+                        << " to the request for its EEPROM area.";
+                throw errors::Error(message.str());
+            }
+            if (status.parameters().size() != size) {
+                std::stringstream message;
+                message << "The actuator " << (int)id << " sent "
+                        << status.parameters().size() << " bytes of its EEPROM area"
+                        << " instead of " << size << ".";
+                throw errors::Error(message.str());
+            }
+
+            _data[id] = status.parameters();
+        }
+
+        /** Value of a field, read from the actuator if it is not cached yet.
+
+            @param controller object handling the USB to dynamixel interface
+            @param id identifier of the actuator
+            @param address address of the field, in the EEPROM area
+            @return value of the field, decoded on sizeof(T) bytes
+            @throws errors::Error if the field is out of the cached area, or if
+                the actuator had to be read and did not answer properly
+        **/
+        template <typename T, typename Controller>
+        T get(const Controller& controller, id_t id, address_t address)
+        {
+            // the area may have been cached before its size was known
+            if (!cached(id) || (address + sizeof(T) > _data[id].size() && address + sizeof(T) <= size(id)))
+                load(controller, id);
+            return get<T>(id, address);
+        }
+
+        /// @see get(const Controller&, id_t, address_t); sizeof(T) must match the field's size
+        template <typename T, typename Controller>
+        T get(const Controller& controller, id_t id, const Field<Protocol>& field)
+        {
+            _check_size<T>(field);
+            return get<T>(controller, id, field.address);
+        }
+
+        /** Value of a field, from the cache only.
+
+            @throws errors::Error if the actuator is not cached or if the field
+                is out of the cached area
+        **/
+        template <typename T>
+        T get(id_t id, address_t address) const
+        {
+            typename std::map<id_t, std::vector<uint8_t>>::const_iterator it = _data.find(id);
+            if (it == _data.end())
+                throw errors::Error("EepromCache: the actuator is not in the cache");
+            if (address + sizeof(T) > it->second.size())
+                throw errors::Error("EepromCache: the field is out of the cached area");
+
+            T value;
+            Protocol::unpack_data(it->second.data(), it->second.size(), address, value);
+            return value;
+        }
+
+        /// @see get(id_t, address_t); sizeof(T) must match the field's size
+        template <typename T>
+        T get(id_t id, const Field<Protocol>& field) const
+        {
+            _check_size<T>(field);
+            return get<T>(id, field.address);
+        }
+
+        /** Forget the EEPROM area of one actuator (broadcast id: all of them);
+            its size is kept
+        **/
+        void invalidate(id_t id)
+        {
+            if (Protocol::broadcast_id == id)
+                _data.clear();
+            else
+                _data.erase(id);
+        }
+
+        /** Forget the EEPROM area of one actuator if a write of length bytes
+            at address overlaps it; the writes in the RAM area keep the cache.
+        **/
+        void invalidate(id_t id, address_t address, size_t length)
+        {
+            if (Protocol::broadcast_id == id) {
+                typename std::map<id_t, std::vector<uint8_t>>::iterator it = _data.begin();
+                while (it != _data.end()) {
+                    if (address < size(it->first) && length > 0)
+                        it = _data.erase(it);
+                    else
+                        ++it;
+                }
+            }
+            else if (address < size(id) && length > 0)
+                invalidate(id);
+        }
+
+        /// Forget the EEPROM area of all the actuators
+        void invalidate()
+        {
+            _data.clear();
+        }
+
+    protected:
+        template <typename T>
+        static void _check_size(const Field<Protocol>& field)
+        {
+            if (sizeof(T) != field.size)
+                throw errors::Error("EepromCache: the value does not have the size of the field");
+        }
+
+        size_t _size;
+        std::map<id_t, size_t> _sizes;
+        std::map<id_t, std::vector<uint8_t>> _data;
+    };
+} // namespace dynamixel
+
+#endif
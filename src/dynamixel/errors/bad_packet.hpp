@@ -1,8 +1,11 @@
 #ifndef DYNAMIXEL_BAD_PACKET_ERROR_HPP_
 #define DYNAMIXEL_BAD_PACKET_ERROR_HPP_
 
+#include <iomanip>
+#include <ostream>
 #include <string>
 #include <stdint.h>
+#include <vector>
 
 #include "error.hpp"
 
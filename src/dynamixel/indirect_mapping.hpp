@@ -0,0 +1,202 @@
+#ifndef DYNAMIXEL_INDIRECT_MAPPING_HPP_
+#define DYNAMIXEL_INDIRECT_MAPPING_HPP_
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "errors/error.hpp"
+#include "instructions/read.hpp"
+#include "instructions/sync_read.hpp"
+#include "instructions/sync_write_builder.hpp"
+#include "instructions/write.hpp"
+#include "read_plan.hpp"
+#include "read_result.hpp"
+#include "servos/model_traits.hpp"
+
+namespace dynamixel {
+    /** Gather scattered fields of the control table in one contiguous block,
+        through the indirect addresses of the actuator.
+
+        The models with an indirect address region (X series, MX with protocol
+        2 and Pro series) have `indirect_address`, `indirect_data` and
+        `indirect_count` in their control table. Each indirect address entry
+        (two bytes) holds the address of one byte of the control table; this
+        byte can then be accessed at the corresponding position of the
+        indirect data region.
+
+            IndirectMapping<Mx28P2> mapping;
+            size_t current = mapping.add(Mx28P2::field_present_current());
+            size_t position = mapping.add(Mx28P2::field_present_position());
+            size_t temperature = mapping.add(Mx28P2::field_present_temperature());
+
+            // once, after each power-up (with torque disabled)
+            controller.send(mapping.write_mapping(ids));
+
+            // at each step, one sync read for all the fields of all actuators
+            mapping.sync_read(controller, ids, data, statuses);
+            int32_t p = mapping.get<int32_t>(data, i, position);
+
+        Depending on the model, the indirect addresses are in the EEPROM area
+        or in the RAM area (in which case they are lost when the actuator is
+        turned off); in both cases, they can only be written while the torque
+        is disabled.
+    **/
+    template <class Model>
+    class IndirectMapping {
+    public:
+        typedef typename servos::ModelTraits<Model>::protocol_t protocol_t;
+        typedef typename servos::ModelTraits<Model>::CT ct_t;
+
+        /** @param first index of the first indirect address to be used (to
+                keep the preceding ones for another mapping)
+        **/
+        explicit IndirectMapping(size_t first = 0) : _first(first), _size(0) {}
+
+        /** Map a field at the end of the block.
+
+            @param field address and size of the field
+            @return index of the field, to be given to `get`
+            @throws errors::Error if there are not enough indirect addresses
+        **/
+        size_t add(const Field<protocol_t>& field)
+        {
+            if (_first + _size + field.size > ct_t::indirect_count)
+                throw errors::Error("IndirectMapping: not enough indirect addresses for this field");
+
+            _fields.push_back(field);
+            _offsets.push_back(_size);
+            _size += field.size;
+            return _fields.size() - 1;
+        }
+
+        /// Number of bytes of the block
+        size_t size() const { return _size; }
+
+        /// Location of the block in the control table
+        Field<protocol_t> block() const
+        {
+            return Field<protocol_t>(ct_t::indirect_data + _first, _size);
+        }
+
+        /// Content of the indirect address entries, for this mapping
+        std::vector<uint8_t> mapping_data() const
+        {
+            std::vector<uint8_t> data(_size * sizeof(typename ct_t::indirect_address_t));
+            if (data.empty())
+                return data;
+
+            size_t offset = 0;
+            for (size_t i = 0; i < _fields.size(); ++i)
+                for (size_t b = 0; b < _fields[i].size; ++b)
+                    offset += protocol_t::pack_data((typename ct_t::indirect_address_t)(_fields[i].address + b),
+                        &data.front(), offset);
+            return data;
+        }
+
+        /// Packet writing the mapping in one actuator
+        InstructionPacket<protocol_t> write_mapping(typename protocol_t::id_t id) const
+        {
+            return instructions::Write<protocol_t>(id, _mapping_address(), mapping_data());
+        }
+
+        /// Packet writing the mapping in several actuators at once
+        InstructionPacket<protocol_t> write_mapping(const std::vector<typename protocol_t::id_t>& ids) const
+        {
+            std::vector<uint8_t> data = mapping_data();
+            instructions::SyncWriteBuilder<protocol_t> builder;
+            builder.build(_mapping_address(), data.size(), ids.data(), data.data(), 0, ids.size());
+            return builder;
+        }
+
+        /// Packet reading the block of one actuator
+        InstructionPacket<protocol_t> read_block(typename protocol_t::id_t id) const
+        {
+            return instructions::Read<protocol_t>(id, ct_t::indirect_data + _first, _size);
+        }
+
+        /// Packet reading the block of several actuators (one reply each)
+        InstructionPacket<protocol_t> sync_read_block(const std::vector<typename protocol_t::id_t>& ids) const
+        {
+            return instructions::SyncRead<protocol_t>(ct_t::indirect_data + _first, _size, ids);
+        }
+
+        /** Read the block of several actuators, with a single sync read.
+
+            No exception is thrown for errors that are specific to one actuator
+            (see recv_replies); the status of each read is given in statuses.
+
+            @param controller object handling the USB to dynamixel interface
+            @param ids identifiers of the actuators
+            @param data the blocks of all actuators, one after the other (the
+                vector is resized, so that it can be reused between calls)
+            @param statuses status of the read, for each actuator
+        **/
+        template <typename Controller>
+        void sync_read(const Controller& controller, const std::vector<typename protocol_t::id_t>& ids,
+            std::vector<uint8_t>& data, std::vector<ReadStatus>& statuses) const
+        {
+            data.resize(ids.size() * _size);
+            statuses.assign(ids.size(), ReadStatus::timeout);
+
+            controller.send(sync_read_block(ids));
+
+            const size_t size = _size;
+            recv_replies<protocol_t>(controller, ids,
+                [&data, &statuses, size](size_t i, const StatusPacket<protocol_t>& status) {
+                    const std::vector<uint8_t>& parameters = status.parameters();
+                    if (parameters.size() != size) {
+                        statuses[i] = ReadStatus::size_mismatch;
+                        return;
+                    }
+                    std::copy(parameters.begin(), parameters.end(), data.begin() + i * size);
+                    statuses[i] = (0 == status.error_byte()) ? ReadStatus::ok : ReadStatus::servo_error;
+                },
+                [&statuses](size_t i, ReadStatus read_status) {
+                    statuses[i] = read_status;
+                });
+        }
+
+        /** Decode one field from a block.
+
+            @param block data read from the block of one actuator
+            @param field index returned by `add`
+            @return value of the field, decoded on sizeof(T) bytes
+        **/
+        template <typename T>
+        T get(const std::vector<uint8_t>& block, size_t field) const
+        {
+            return get<T>(block, 0, field);
+        }
+
+        /** Decode one field of one actuator, from the blocks filled by
+            `sync_read`.
+
+            @param data blocks of all actuators
+            @param index position of the actuator in the ids given to sync_read
+            @param field index returned by `add`
+        **/
+        template <typename T>
+        T get(const std::vector<uint8_t>& data, size_t index, size_t field) const
+        {
+            T value;
+            protocol_t::unpack_data(data.data(), data.size(), index * _size + _offsets.at(field), value);
+            return value;
+        }
+
+    protected:
+        typename protocol_t::address_t _mapping_address() const
+        {
+            return ct_t::indirect_address + _first * sizeof(typename ct_t::indirect_address_t);
+        }
+
+        size_t _first;
+        size_t _size;
+        std::vector<Field<protocol_t>> _fields;
+        // position of each field in the block
+        std::vector<size_t> _offsets;
+    };
+} // namespace dynamixel
+
+#endif
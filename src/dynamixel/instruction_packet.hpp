@@ -22,6 +22,9 @@ namespace dynamixel {
         const uint8_t* data() const { return &_packet.front(); }
 
     protected:
+        // for the subclasses that fill _packet themselves
+        InstructionPacket() {}
+
         std::vector<uint8_t> _packet;
     };
 } // namespace dynamixel
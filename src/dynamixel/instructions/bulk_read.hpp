@@ -23,7 +23,7 @@ namespace dynamixel {
                 if (ids.size() == 0)
                     throw errors::Error("BulkRead: ids vector of size zero");
 
-                std::vector<uint8_t> parameters(3 * ids.size() + 3);
+                std::vector<uint8_t> parameters(3 * ids.size() + 1);
 
                 parameters[0] = 0x00;
 
@@ -39,22 +39,22 @@ namespace dynamixel {
                 return parameters;
             }
 
+            // version 2 of the protocol: id, address and length (two bytes
+            // each, but the id) for each actuator
             std::vector<uint8_t> _get_parameters(const std::vector<uint16_t>& address, const std::vector<typename T::id_t>& ids,
-                const std::vector<uint16_t>& data_length)
+                const std::vector<uint8_t>& data_length)
             {
                 if (ids.size() == 0)
                     throw errors::Error("BulkRead: ids vector of size zero");
 
-                std::vector<uint8_t> parameters(3 * ids.size() + 3);
+                std::vector<uint8_t> parameters(5 * ids.size());
 
-                parameters[0] = 0x00;
                 for (size_t m = 0; m < ids.size(); m++) {
-                    parameters[m + 1] = (uint8_t)(data_length[m] & 0xFF);
-                    parameters[m + 2] = (uint8_t)(data_length[m] >> 8) & 0xFF;
-                    parameters[m + 3] = (uint8_t)(ids[m] & 0xFF);
-                    parameters[m + 4] = (uint8_t)(ids[m] >> 8) & 0xFF;
-                    parameters[m + 5] = (uint8_t)(address[m] & 0xFF);
-                    parameters[m + 6] = (uint8_t)(address[m] >> 8) & 0xFF;
+                    parameters[5 * m] = ids[m];
+                    parameters[5 * m + 1] = (uint8_t)(address[m] & 0xFF);
+                    parameters[5 * m + 2] = (uint8_t)(address[m] >> 8) & 0xFF;
+                    parameters[5 * m + 3] = data_length[m];
+                    parameters[5 * m + 4] = 0x00;
                 }
 
                 return parameters;
@@ -0,0 +1,49 @@
+#ifndef DYNAMIXEL_INSTRUCTIONS_BULK_WRITE_HPP_
+#define DYNAMIXEL_INSTRUCTIONS_BULK_WRITE_HPP_
+
+#include <stdint.h>
+
+#include "../instruction_packet.hpp"
+#include "../errors/error.hpp"
+
+namespace dynamixel {
+    namespace instructions {
+        /** Write a different range of the control table of several actuators
+            (protocol 2 only).
+
+            Contrary to the sync write, each actuator has its own address and
+            length. No actuator replies, and an actuator can only appear once.
+        **/
+        template <class T>
+        class BulkWrite : public InstructionPacket<T> {
+        public:
+            BulkWrite(const std::vector<typename T::id_t>& ids, const std::vector<typename T::address_t>& addresses,
+                const std::vector<std::vector<uint8_t>>& data)
+                : InstructionPacket<T>(T::broadcast_id, T::Instructions::bulk_write, _get_parameters(ids, addresses, data)) {}
+
+        protected:
+            std::vector<uint8_t> _get_parameters(const std::vector<typename T::id_t>& ids,
+                const std::vector<uint16_t>& addresses, const std::vector<std::vector<uint8_t>>& data)
+            {
+                if (ids.size() == 0)
+                    throw errors::Error("BulkWrite: ids vector of size zero");
+                if (ids.size() != addresses.size() || ids.size() != data.size())
+                    throw errors::Error("BulkWrite: mismatching vectors size for ids, addresses and data");
+
+                std::vector<uint8_t> parameters;
+                for (size_t i = 0; i < ids.size(); ++i) {
+                    parameters.push_back(ids[i]);
+                    parameters.push_back((uint8_t)(addresses[i] & 0xFF));
+                    parameters.push_back((uint8_t)((addresses[i] >> 8) & 0xFF));
+                    parameters.push_back((uint8_t)(data[i].size() & 0xFF));
+                    parameters.push_back((uint8_t)((data[i].size() >> 8) & 0xFF));
+                    parameters.insert(parameters.end(), data[i].begin(), data[i].end());
+                }
+
+                return parameters;
+            }
+        };
+    } // namespace instructions
+} // namespace dynamixel
+
+#endif
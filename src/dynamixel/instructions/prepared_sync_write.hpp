@@ -0,0 +1,214 @@
+#ifndef DYNAMIXEL_INSTRUCTIONS_PREPARED_SYNC_WRITE_HPP_
+#define DYNAMIXEL_INSTRUCTIONS_PREPARED_SYNC_WRITE_HPP_
+
+#include <stdint.h>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "../instruction_packet.hpp"
+#include "../protocols.hpp"
+#include "sync_write_builder.hpp"
+
+namespace dynamixel {
+    namespace instructions {
+        /** Incremental update of the checksum of a prepared packet, when some
+            of its slots are modified.
+
+            See the protocol-specific implementations for details.
+        **/
+        template <class Protocol>
+        class PreparedChecksum;
+
+        /** For protocol 1, the checksum is the complement of the sum of the
+            bytes: it is directly updated with the difference between the new
+            and old values of each modified byte.
+        **/
+        template <>
+        class PreparedChecksum<protocols::Protocol1> {
+        public:
+            void prepare(const uint8_t* packet, size_t first_slot, size_t slot_size, size_t count)
+            {
+                _checksum_pos = first_slot + slot_size * count;
+                _sum = ~packet[_checksum_pos];
+            }
+
+            void modified(size_t slot, uint8_t old_byte, uint8_t new_byte)
+            {
+                _sum += new_byte - old_byte;
+            }
+
+            void finalize(uint8_t* packet)
+            {
+                packet[_checksum_pos] = ~_sum;
+            }
+
+        protected:
+            size_t _checksum_pos;
+            uint8_t _sum;
+        };
+
+        /** For protocol 2, the CRC has to be computed sequentially. The CRC of
+            the bytes preceding each slot is cached, so that it is only
+            recomputed from the first modified slot.
+        **/
+        template <>
+        class PreparedChecksum<protocols::Protocol2> {
+        public:
+            void prepare(const uint8_t* packet, size_t first_slot, size_t slot_size, size_t count)
+            {
+                _first_slot = first_slot;
+                _slot_size = slot_size;
+                _crc_before.resize(count);
+                _crc_before[0] = protocols::Protocol2::crc(packet, first_slot);
+                for (size_t i = 1; i < count; ++i)
+                    _crc_before[i] = protocols::Protocol2::crc(packet + _slot(i - 1), slot_size, _crc_before[i - 1]);
+                _first_dirty = count;
+            }
+
+            void modified(size_t slot, uint8_t old_byte, uint8_t new_byte)
+            {
+                if (slot < _first_dirty)
+                    _first_dirty = slot;
+            }
+
+            void finalize(uint8_t* packet)
+            {
+                size_t count = _crc_before.size();
+                if (_first_dirty >= count)
+                    return;
+
+                uint16_t crc = _crc_before[_first_dirty];
+                for (size_t i = _first_dirty; i < count; ++i) {
+                    _crc_before[i] = crc;
+                    crc = protocols::Protocol2::crc(packet + _slot(i), _slot_size, crc);
+                }
+                _first_dirty = count;
+
+                size_t checksum_pos = _slot(count);
+                packet[checksum_pos] = (uint8_t)(crc & 0xFF);
+                packet[checksum_pos + 1] = (uint8_t)((crc >> 8) & 0xFF);
+            }
+
+        protected:
+            size_t _slot(size_t i) const { return _first_slot + i * _slot_size; }
+
+            size_t _first_slot;
+            size_t _slot_size;
+            size_t _first_dirty;
+            // CRC of the packet up to (and excluding) each slot
+            std::vector<uint16_t> _crc_before;
+        };
+
+        /** Sync write packet for a fixed set of actuators, address and data
+            length, whose values are updated in place.
+
+            This is meant for control loops that send the same kind of command
+            at each step: the packet is built once, and then only the modified
+            bytes and the checksum are updated, without any allocation.
+
+                PreparedSyncWrite<Protocol2> goals(116, 4, ids);
+                while (running) {
+                    for (size_t i = 0; i < ids.size(); ++i)
+                        goals.set(i, positions[i]);
+                    controller.send(goals.finalize());
+                }
+
+            `finalize` must be called after the last `set` and before the
+            packet is sent.
+        **/
+        template <class T>
+        class PreparedSyncWrite : public InstructionPacket<T> {
+        public:
+            /** Build the packet, with all values set to zero.
+
+                @param address first address of the written field(s)
+                @param data_length number of bytes written in each actuator
+                @param ids array of count ids
+                @param count number of actuators
+                @throws errors::Error if count is zero
+            **/
+            PreparedSyncWrite(typename T::address_t address, typename T::length_t data_length,
+                const typename T::id_t* ids, size_t count)
+            {
+                _prepare(address, data_length, ids, count);
+            }
+
+            PreparedSyncWrite(typename T::address_t address, typename T::length_t data_length,
+                const std::vector<typename T::id_t>& ids)
+            {
+                _prepare(address, data_length, ids.data(), ids.size());
+            }
+
+            /** Replace the data of the i-th actuator.
+
+                @param i index of the actuator, in the list given to the constructor
+                @param data data_length bytes
+            **/
+            PreparedSyncWrite& set_raw(size_t i, const uint8_t* data)
+            {
+                assert(i < _count);
+                uint8_t* slot_data = &this->_packet.front() + _first_slot + i * _slot_size + 1;
+                for (size_t j = 0; j < _data_length; ++j) {
+                    if (slot_data[j] != data[j]) {
+                        _checksum.modified(i, slot_data[j], data[j]);
+                        slot_data[j] = data[j];
+                    }
+                }
+
+                return *this;
+            }
+
+            /** Replace the value of the i-th actuator.
+
+                @param i index of the actuator, in the list given to the constructor
+                @param value new value; sizeof(V) must match the data length
+            **/
+            template <typename V>
+            PreparedSyncWrite& set(size_t i, V value)
+            {
+                assert(sizeof(V) == _data_length);
+                uint8_t data[sizeof(V)];
+                T::pack_data(value, data);
+
+                return set_raw(i, data);
+            }
+
+            /// Update the checksum after the values were modified
+            PreparedSyncWrite& finalize()
+            {
+                _checksum.finalize(&this->_packet.front());
+
+                return *this;
+            }
+
+            size_t count() const { return _count; }
+
+        protected:
+            void _prepare(typename T::address_t address, typename T::length_t data_length,
+                const typename T::id_t* ids, size_t count)
+            {
+                std::vector<uint8_t> zeros(data_length, 0);
+                SyncWriteBuilder<T> builder;
+                builder.build(address, data_length, ids, zeros.data(), 0, count);
+                this->_packet.assign(builder.data(), builder.data() + builder.size());
+
+                _data_length = data_length;
+                _count = count;
+                _slot_size = data_length + 1;
+                _first_slot = T::instruction_header_size
+                    + sizeof(typename T::address_t) + sizeof(typename T::length_t);
+                _checksum.prepare(&this->_packet.front(), _first_slot, _slot_size, count);
+            }
+
+            size_t _data_length;
+            size_t _count;
+            size_t _slot_size;
+            // position, in the packet, of the first actuator's id
+            size_t _first_slot;
+            PreparedChecksum<T> _checksum;
+        };
+    } // namespace instructions
+} // namespace dynamixel
+
+#endif
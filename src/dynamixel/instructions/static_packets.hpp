@@ -0,0 +1,156 @@
+#ifndef DYNAMIXEL_INSTRUCTIONS_STATIC_PACKETS_HPP_
+#define DYNAMIXEL_INSTRUCTIONS_STATIC_PACKETS_HPP_
+
+#include <stdint.h>
+#include <array>
+#include <cstddef>
+
+#include "../protocols.hpp"
+
+namespace dynamixel {
+    namespace instructions {
+        /** Instruction packets built by constexpr functions, as std::arrays.
+
+            When the arguments (id, address, ...) are known at compile time,
+            the whole packet, checksum included, is computed by the compiler:
+
+                constexpr auto ping = StaticPackets<Protocol2>::ping(1);
+                controller.send(ping);
+
+            Only the simple instructions with a fixed number of parameters are
+            available. See the protocol-specific implementations for details.
+        **/
+        template <class Protocol>
+        struct StaticPackets;
+
+        template <>
+        struct StaticPackets<protocols::Protocol1> {
+            typedef protocols::Protocol1 protocol_t;
+
+            typedef std::array<uint8_t, 6> ping_t;
+            typedef std::array<uint8_t, 8> read_t;
+            typedef std::array<uint8_t, 6> action_t;
+
+            /** Build a complete instruction packet.
+
+                @param id identifier of the target actuator
+                @param instr instruction code
+                @param params parameters of the instruction, one byte each
+                @return the packet, with its checksum
+            **/
+            template <typename... Params>
+            static constexpr std::array<uint8_t, 6 + sizeof...(Params)>
+            instruction(protocol_t::id_t id, protocol_t::instr_t instr, Params... params)
+            {
+                return std::array<uint8_t, 6 + sizeof...(Params)>{{0xFF, 0xFF, id,
+                    (uint8_t)(sizeof...(Params) + 2), instr, static_cast<uint8_t>(params)...,
+                    (uint8_t)~_sum(id, sizeof...(Params) + 2, instr, params...)}};
+            }
+
+            static constexpr ping_t ping(protocol_t::id_t id)
+            {
+                return instruction(id, protocol_t::Instructions::ping);
+            }
+
+            static constexpr read_t read(protocol_t::id_t id, protocol_t::address_t address,
+                protocol_t::length_t length)
+            {
+                return instruction(id, protocol_t::Instructions::read, address, length);
+            }
+
+            static constexpr action_t action(protocol_t::id_t id = protocol_t::broadcast_id)
+            {
+                return instruction(id, protocol_t::Instructions::action);
+            }
+
+        protected:
+            static constexpr uint8_t _sum()
+            {
+                return 0;
+            }
+
+            template <typename... Bytes>
+            static constexpr uint8_t _sum(unsigned first, Bytes... rest)
+            {
+                return (uint8_t)(first + _sum(rest...));
+            }
+        };
+
+        template <>
+        struct StaticPackets<protocols::Protocol2> {
+            typedef protocols::Protocol2 protocol_t;
+
+            typedef std::array<uint8_t, 10> ping_t;
+            typedef std::array<uint8_t, 14> read_t;
+            typedef std::array<uint8_t, 10> action_t;
+
+            /** Build a complete instruction packet.
+
+                @param id identifier of the target actuator
+                @param instr instruction code
+                @param params parameters of the instruction, one byte each
+                @return the packet, with its CRC
+            **/
+            template <typename... Params>
+            static constexpr std::array<uint8_t, 10 + sizeof...(Params)>
+            instruction(protocol_t::id_t id, protocol_t::instr_t instr, Params... params)
+            {
+                return _with_crc(0xFF, 0xFF, 0xFD, 0x00, id,
+                    (sizeof...(Params) + 3) & 0xFF, ((sizeof...(Params) + 3) >> 8) & 0xFF,
+                    instr, params...);
+            }
+
+            static constexpr ping_t ping(protocol_t::id_t id)
+            {
+                return instruction(id, protocol_t::Instructions::ping);
+            }
+
+            static constexpr read_t read(protocol_t::id_t id, protocol_t::address_t address,
+                protocol_t::length_t length)
+            {
+                return instruction(id, protocol_t::Instructions::read,
+                    address & 0xFF, (address >> 8) & 0xFF, length & 0xFF, (length >> 8) & 0xFF);
+            }
+
+            static constexpr action_t action(protocol_t::id_t id = protocol_t::broadcast_id)
+            {
+                return instruction(id, protocol_t::Instructions::action);
+            }
+
+        protected:
+            template <typename... Bytes>
+            static constexpr std::array<uint8_t, 2 + sizeof...(Bytes)> _with_crc(Bytes... bytes)
+            {
+                return _append_crc(_crc(0, bytes...), bytes...);
+            }
+
+            template <typename... Bytes>
+            static constexpr std::array<uint8_t, 2 + sizeof...(Bytes)> _append_crc(uint16_t crc, Bytes... bytes)
+            {
+                return std::array<uint8_t, 2 + sizeof...(Bytes)>{{static_cast<uint8_t>(bytes)...,
+                    (uint8_t)(crc & 0xFF), (uint8_t)((crc >> 8) & 0xFF)}};
+            }
+
+            // same CRC as Protocol2::crc (polynomial 0x8005), computed bit by bit
+            static constexpr uint16_t _crc(uint16_t crc)
+            {
+                return crc;
+            }
+
+            template <typename... Bytes>
+            static constexpr uint16_t _crc(uint16_t crc, unsigned first, Bytes... rest)
+            {
+                return _crc(_crc_bits(crc ^ ((first & 0xFF) << 8), 8), rest...);
+            }
+
+            static constexpr uint16_t _crc_bits(unsigned crc, unsigned bits)
+            {
+                return bits == 0
+                    ? (uint16_t)crc
+                    : _crc_bits((crc & 0x8000) ? ((crc << 1) ^ 0x8005) & 0xFFFF : (crc << 1) & 0xFFFF, bits - 1);
+            }
+        };
+    } // namespace instructions
+} // namespace dynamixel
+
+#endif
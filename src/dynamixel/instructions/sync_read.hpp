@@ -0,0 +1,47 @@
+#ifndef DYNAMIXEL_INSTRUCTIONS_SYNC_READ_HPP_
+#define DYNAMIXEL_INSTRUCTIONS_SYNC_READ_HPP_
+
+#include <stdint.h>
+
+#include "../instruction_packet.hpp"
+#include "../errors/error.hpp"
+
+namespace dynamixel {
+    namespace instructions {
+        /** Read the same range of the control table of several actuators
+            (protocol 2 only).
+
+            Each actuator replies with its own status packet, in the order of
+            the ids.
+        **/
+        template <class T>
+        class SyncRead : public InstructionPacket<T> {
+        public:
+            SyncRead(typename T::address_t address, typename T::length_t length,
+                const std::vector<typename T::id_t>& ids)
+                : InstructionPacket<T>(T::broadcast_id, T::Instructions::sync_read, _get_parameters(address, length, ids)) {}
+
+        protected:
+            std::vector<uint8_t> _get_parameters(uint16_t address, uint16_t length,
+                const std::vector<typename T::id_t>& ids)
+            {
+                if (ids.size() == 0)
+                    throw errors::Error("SyncRead: ids vector of size zero");
+
+                std::vector<uint8_t> parameters(ids.size() + 4);
+
+                parameters[0] = (uint8_t)(address & 0xFF);
+                parameters[1] = (uint8_t)((address >> 8) & 0xFF);
+                parameters[2] = (uint8_t)(length & 0xFF);
+                parameters[3] = (uint8_t)((length >> 8) & 0xFF);
+
+                for (size_t i = 0; i < ids.size(); ++i)
+                    parameters[4 + i] = ids[i];
+
+                return parameters;
+            }
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,170 @@
+#ifndef DYNAMIXEL_INSTRUCTIONS_SYNC_WRITE_BUILDER_HPP_
+#define DYNAMIXEL_INSTRUCTIONS_SYNC_WRITE_BUILDER_HPP_
+
+#include <stdint.h>
+#include <cstddef>
+#include <cassert>
+#include <cstring>
+
+#include "../instruction_packet.hpp"
+#include "../errors/error.hpp"
+
+namespace dynamixel {
+    namespace instructions {
+        /** Sync write instruction, built directly in the packet buffer.
+
+            Contrary to SyncWrite, no intermediate vector is created for the
+            data of each actuator: the values are written in place, in a buffer
+            that is kept (along with its capacity) from one packet to the next.
+            Reusing the same builder for a periodic command thus does not
+            allocate memory once the first packet was built.
+
+            The packet can either be built in one call (`build`), or in three
+            steps:
+
+                builder.start(address, sizeof(value_t), count);
+                for (size_t i = 0; i < count; ++i)
+                    builder.set(i, ids[i], values[i]);
+                builder.finalize();
+
+            In both cases, the builder can then be sent like any other
+            instruction packet.
+        **/
+        template <class T>
+        class SyncWriteBuilder : public InstructionPacket<T> {
+        public:
+            SyncWriteBuilder() : _data_length(0), _count(0) {}
+
+            /** Prepare the packet for a given number of actuators.
+
+                The header and the address are written; the id and data of
+                each actuator must then be given with `set` before the packet is
+                finalized.
+
+                @param address first address of the written field(s)
+                @param data_length number of bytes written in each actuator
+                @param count number of actuators
+                @throws errors::Error if count is zero
+            **/
+            SyncWriteBuilder& start(typename T::address_t address, typename T::length_t data_length, size_t count)
+            {
+                if (count == 0)
+                    throw errors::Error("SyncWrite: ids vector of size zero");
+
+                _data_length = data_length;
+                _count = count;
+                this->_packet.resize(T::instruction_header_size + _parameters_size() + T::checksum_size);
+
+                uint8_t* packet = &this->_packet.front();
+                size_t offset = T::write_instruction_header(packet, T::broadcast_id, T::Instructions::sync_write, _parameters_size());
+                offset += T::pack_data(address, packet, offset);
+                T::pack_data(data_length, packet, offset);
+
+                return *this;
+            }
+
+            /** Set the raw data for the i-th actuator.
+
+                @param i index of the actuator, in [0, count)
+                @param id id of this actuator
+                @param data data_length bytes to be written
+            **/
+            SyncWriteBuilder& set_raw(size_t i, typename T::id_t id, const uint8_t* data)
+            {
+                uint8_t* slot = _slot(i);
+                slot[0] = id;
+                std::memcpy(slot + 1, data, _data_length);
+
+                return *this;
+            }
+
+            /** Set the value for the i-th actuator.
+
+                @param i index of the actuator, in [0, count)
+                @param id id of this actuator
+                @param value to be written; sizeof(V) must match the data length
+                    given to `start`
+            **/
+            template <typename V>
+            SyncWriteBuilder& set(size_t i, typename T::id_t id, V value)
+            {
+                assert(sizeof(V) == _data_length);
+                uint8_t* slot = _slot(i);
+                slot[0] = id;
+                T::pack_data(value, slot, 1);
+
+                return *this;
+            }
+
+            /// Compute and write the checksum, once all the slots were set
+            SyncWriteBuilder& finalize()
+            {
+                T::finalize_checksum(&this->_packet.front(), _parameters_size());
+
+                return *this;
+            }
+
+            /** Build the whole packet from raw data.
+
+                @param address first address of the written field(s)
+                @param data_length number of bytes written in each actuator
+                @param ids array of count ids
+                @param data data of the first actuator; the data of the i-th one
+                    starts at data + i * stride
+                @param stride distance, in bytes, between the data of two
+                    consecutive actuators
+                @param count number of actuators
+            **/
+            SyncWriteBuilder& build(typename T::address_t address, typename T::length_t data_length,
+                const typename T::id_t* ids, const uint8_t* data, size_t stride, size_t count)
+            {
+                start(address, data_length, count);
+                for (size_t i = 0; i < count; ++i)
+                    set_raw(i, ids[i], data + i * stride);
+
+                return finalize();
+            }
+
+            /** Build the whole packet from typed values.
+
+                @param address address of the written field
+                @param ids array of count ids
+                @param values array of count values, encoded on sizeof(V) bytes
+                @param count number of actuators
+            **/
+            template <typename V>
+            SyncWriteBuilder& build(typename T::address_t address, const typename T::id_t* ids,
+                const V* values, size_t count)
+            {
+                start(address, sizeof(V), count);
+                for (size_t i = 0; i < count; ++i)
+                    set(i, ids[i], values[i]);
+
+                return finalize();
+            }
+
+            size_t count() const { return _count; }
+
+        protected:
+            size_t _parameters_size() const
+            {
+                // address and data length are encoded like address_t and length_t
+                return sizeof(typename T::address_t) + sizeof(typename T::length_t)
+                    + (_data_length + 1) * _count;
+            }
+
+            uint8_t* _slot(size_t i)
+            {
+                assert(i < _count);
+                return &this->_packet.front() + T::instruction_header_size
+                    + sizeof(typename T::address_t) + sizeof(typename T::length_t)
+                    + i * (_data_length + 1);
+            }
+
+            size_t _data_length;
+            size_t _count;
+        };
+    } // namespace instructions
+} // namespace dynamixel
+
+#endif
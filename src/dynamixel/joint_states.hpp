@@ -0,0 +1,91 @@
+#ifndef DYNAMIXEL_JOINT_STATES_HPP_
+#define DYNAMIXEL_JOINT_STATES_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "read_result.hpp"
+
+namespace dynamixel {
+    /** State of several joints, stored as a structure of arrays.
+
+        Each joint has a slot, and each quantity is stored in its own
+        contiguous array of doubles, so that it can be used in place by other
+        libraries; with Eigen for instance:
+
+            Eigen::Map<Eigen::VectorXd> q(states.positions(), states.size());
+
+        The quantities are:
+            - positions, in radians,
+            - velocities, in radians per second,
+            - loads, as the raw value of the model's present_load field (the
+              unit depends on the model; NaN for the models without this field),
+            - temperatures, in degrees Celsius,
+            - timestamps, in seconds (same clock as dynamixel::get_time), at
+              which the joint was last read.
+
+        The arrays are filled by batched reads, like
+        servos::ServoGroup::read_states. Before the first successful read of a
+        joint, its values are NaN.
+    **/
+    class JointStates {
+    public:
+        explicit JointStates(size_t count = 0)
+        {
+            resize(count);
+        }
+
+        /// Change the number of slots; all the values are reset
+        void resize(size_t count)
+        {
+            const double nan = std::numeric_limits<double>::quiet_NaN();
+            _positions.assign(count, nan);
+            _velocities.assign(count, nan);
+            _loads.assign(count, nan);
+            _temperatures.assign(count, nan);
+            _timestamps.assign(count, nan);
+            _statuses.assign(count, ReadStatus::timeout);
+        }
+
+        size_t size() const { return _positions.size(); }
+
+        double* positions() { return _positions.data(); }
+        const double* positions() const { return _positions.data(); }
+
+        double* velocities() { return _velocities.data(); }
+        const double* velocities() const { return _velocities.data(); }
+
+        double* loads() { return _loads.data(); }
+        const double* loads() const { return _loads.data(); }
+
+        double* temperatures() { return _temperatures.data(); }
+        const double* temperatures() const { return _temperatures.data(); }
+
+        double* timestamps() { return _timestamps.data(); }
+        const double* timestamps() const { return _timestamps.data(); }
+
+        /// Outcome of the last read of each joint
+        ReadStatus* statuses() { return _statuses.data(); }
+        const ReadStatus* statuses() const { return _statuses.data(); }
+
+        /// Current time, in seconds, as used for the timestamps
+        static double now()
+        {
+            return std::chrono::duration<double>(
+                std::chrono::system_clock::now().time_since_epoch())
+                .count();
+        }
+
+    protected:
+        std::vector<double> _positions;
+        std::vector<double> _velocities;
+        std::vector<double> _loads;
+        std::vector<double> _temperatures;
+        std::vector<double> _timestamps;
+        std::vector<ReadStatus> _statuses;
+    };
+} // namespace dynamixel
+
+#endif
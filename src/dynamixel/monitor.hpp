@@ -0,0 +1,263 @@
+#ifndef DYNAMIXEL_MONITOR_HPP_
+#define DYNAMIXEL_MONITOR_HPP_
+
+#include <stdint.h>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <cstddef>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "batch.hpp"
+#include "errors/error.hpp"
+#include "read_plan.hpp"
+#include "read_result.hpp"
+#include "status_packet.hpp"
+
+namespace dynamixel {
+    /// Format of the samples written by a Monitor
+    enum class MonitorFormat {
+        csv,
+        binary
+    };
+
+    /** Periodic sampling of some fields of several actuators, written as
+        timestamped rows (telemetry).
+
+        All the fields of a sample are read with a BatchRead (so with as few
+        bulk or sync reads as the protocol allows). `run` samples at a fixed
+        rate; a sample whose period was spent by the previous reads is
+        skipped and counted as missed, so that the rows stay on the schedule.
+
+            Monitor<Protocol1> monitor;
+            monitor.add(1, "position", Mx28::field_present_position());
+            monitor.add(2, "position", Mx28::field_present_position());
+            Monitor<Protocol1>::Report report
+                = monitor.run(controller, 100, std::cout, MonitorFormat::csv, 1000);
+
+        Output formats:
+            - csv: a header line (`time,<id>:<name>,...`), then one line per
+              sample with the time in seconds since the start, and the value of
+              each column (left empty when the read failed),
+            - binary: the same header line, then one record per sample, with
+              the time (double, in seconds) and, for each column, its status
+              (uint8_t, ReadStatus) and its value (int32_t); all are little
+              endian.
+    **/
+    template <class Protocol>
+    class Monitor {
+    public:
+        typedef typename Protocol::id_t id_t;
+        typedef std::chrono::steady_clock clock_t;
+
+        /// One sampled field of one actuator
+        struct Column {
+            id_t id;
+            std::string name;
+            Field<Protocol> field;
+            bool is_signed;
+        };
+
+        /// Values of all the columns at a given time
+        struct Sample {
+            double time;
+            std::vector<int64_t> values;
+            std::vector<ReadStatus> statuses;
+        };
+
+        /// Outcome of `run`
+        struct Report {
+            Report() : samples(0), missed(0), failed_reads(0), duration(0), target_rate(0) {}
+
+            /// Number of samples written
+            size_t samples;
+            /// Number of periods skipped because the reads did not fit in them
+            size_t missed;
+            /// Number of fields that could not be read, over all samples
+            size_t failed_reads;
+            /// Time spent sampling, in seconds
+            double duration;
+            double target_rate;
+
+            /// Number of samples written per second
+            double rate() const
+            {
+                return duration > 0 ? samples / duration : 0;
+            }
+        };
+
+        /** Add a column.
+
+            @param id identifier of the actuator
+            @param name name of the field, used in the header
+            @param field location of the field, on 1, 2 or 4 bytes
+            @param is_signed whether the value is signed (two's complement)
+            @param bulk whether the actuator answers bulk and sync reads
+                (@see BatchRead::add)
+            @throws errors::Error if the field has another size
+        **/
+        void add(id_t id, const std::string& name, const Field<Protocol>& field, bool is_signed = false,
+            bool bulk = true)
+        {
+            if (1 != field.size && 2 != field.size && 4 != field.size)
+                throw errors::Error("Monitor: the fields must be on 1, 2 or 4 bytes");
+
+            Column column = {id, name, field, is_signed};
+            _columns.push_back(column);
+            _batch.add(id, field, bulk);
+        }
+
+        const std::vector<Column>& columns() const { return _columns; }
+
+        /** Read all the columns once.
+
+            @param controller object handling the USB to dynamixel interface
+            @param time timestamp of the sample
+            @param sample values and statuses of the reads (output)
+        **/
+        template <typename Controller>
+        void sample(const Controller& controller, double time, Sample& sample) const
+        {
+            std::vector<StatusPacket<Protocol>> replies;
+            _batch.read(controller, replies, sample.statuses);
+
+            sample.time = time;
+            sample.values.assign(_columns.size(), 0);
+            for (size_t i = 0; i < _columns.size(); ++i)
+                if (ReadStatus::ok == sample.statuses[i] || ReadStatus::servo_error == sample.statuses[i])
+                    sample.values[i] = _decode(_columns[i], replies[i].parameters());
+        }
+
+        /// Write the header line, listing the columns
+        void write_header(std::ostream& out) const
+        {
+            out << "time";
+            for (size_t i = 0; i < _columns.size(); ++i)
+                out << "," << (int)_columns[i].id << ":" << _columns[i].name;
+            out << "\n";
+        }
+
+        /// Write one sample, in the given format
+        void write(std::ostream& out, const Sample& sample, MonitorFormat format) const
+        {
+            if (MonitorFormat::csv == format) {
+                out << std::fixed << std::setprecision(6) << sample.time;
+                for (size_t i = 0; i < sample.values.size(); ++i) {
+                    out << ",";
+                    if (ReadStatus::ok == sample.statuses[i] || ReadStatus::servo_error == sample.statuses[i])
+                        out << sample.values[i];
+                }
+                out << "\n";
+            }
+            else {
+                uint64_t time;
+                static_assert(sizeof(time) == sizeof(sample.time), "a double is expected on 64 bits");
+                std::memcpy(&time, &sample.time, sizeof(time));
+                _write_le(out, time, sizeof(time));
+                for (size_t i = 0; i < sample.values.size(); ++i) {
+                    out.put((char)sample.statuses[i]);
+                    _write_le(out, (uint32_t)sample.values[i], 4);
+                }
+            }
+        }
+
+        /** Sample all the columns at a fixed rate, and write the samples.
+
+            @param controller object handling the USB to dynamixel interface
+            @param rate target number of samples per second; 0 samples as fast
+                as possible
+            @param out stream receiving the header and the samples
+            @param format format of the samples
+            @param n_samples number of samples to write; 0 for no limit
+            @param duration time after which the sampling stops, in seconds; 0
+                for no limit
+            @param stop the sampling stops as soon as it is non zero (for
+                instance, set by a signal handler); may be null
+            @return number of samples, achieved rate and missed samples
+        **/
+        template <typename Controller>
+        Report run(const Controller& controller, double rate, std::ostream& out,
+            MonitorFormat format = MonitorFormat::csv, size_t n_samples = 0, double duration = 0,
+            const volatile std::sig_atomic_t* stop = nullptr) const
+        {
+            Report report;
+            report.target_rate = rate;
+            Sample row;
+
+            write_header(out);
+
+            const clock_t::time_point start = clock_t::now();
+            const clock_t::duration period = (rate > 0)
+                ? std::chrono::duration_cast<clock_t::duration>(std::chrono::duration<double>(1 / rate))
+                : clock_t::duration::zero();
+            clock_t::time_point next = start;
+
+            while ((0 == n_samples || report.samples < n_samples) && !(stop && *stop)) {
+                clock_t::time_point now = clock_t::now();
+                if (duration > 0 && _seconds(now - start) >= duration)
+                    break;
+
+                sample(controller, _seconds(now - start), row);
+                write(out, row, format);
+                ++report.samples;
+                for (size_t i = 0; i < row.statuses.size(); ++i)
+                    if (ReadStatus::ok != row.statuses[i] && ReadStatus::servo_error != row.statuses[i])
+                        ++report.failed_reads;
+
+                if (period == clock_t::duration::zero())
+                    continue;
+
+                // skip the periods that were spent reading
+                next += period;
+                now = clock_t::now();
+                while (next < now) {
+                    next += period;
+                    ++report.missed;
+                }
+                std::this_thread::sleep_until(next);
+            }
+
+            out.flush();
+            report.duration = _seconds(clock_t::now() - start);
+            return report;
+        }
+
+    protected:
+        static double _seconds(clock_t::duration d)
+        {
+            return std::chrono::duration_cast<std::chrono::duration<double>>(d).count();
+        }
+
+        static int64_t _decode(const Column& column, const std::vector<uint8_t>& data)
+        {
+            if (1 == column.field.size) {
+                uint8_t value;
+                Protocol::unpack_data(data.data(), data.size(), 0, value);
+                return column.is_signed ? (int64_t)(int8_t)value : (int64_t)value;
+            }
+            else if (2 == column.field.size) {
+                uint16_t value;
+                Protocol::unpack_data(data.data(), data.size(), 0, value);
+                return column.is_signed ? (int64_t)(int16_t)value : (int64_t)value;
+            }
+            uint32_t value;
+            Protocol::unpack_data(data.data(), data.size(), 0, value);
+            return column.is_signed ? (int64_t)(int32_t)value : (int64_t)value;
+        }
+
+        static void _write_le(std::ostream& out, uint64_t value, size_t size)
+        {
+            for (size_t i = 0; i < size; ++i)
+                out.put((char)((value >> (8 * i)) & 0xFF));
+        }
+
+        std::vector<Column> _columns;
+        BatchRead<Protocol> _batch;
+    };
+} // namespace dynamixel
+
+#endif
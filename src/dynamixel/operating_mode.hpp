@@ -1,15 +1,48 @@
 #ifndef DYNAMIXEL_OPERATING_MODE_HPP_
 #define DYNAMIXEL_OPERATING_MODE_HPP_
 
+#include "eeprom_cache.hpp"
 #include "errors/error.hpp"
+#include "instructions/bulk_read.hpp"
+#include "instructions/sync_read.hpp"
+#include "read_result.hpp"
 #include "servos.hpp"
 
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace dynamixel {
     using namespace protocols;
 
+    /// Operating mode of a Protocol1 actuator, given its angle limits
+    inline OperatingMode angle_limits2mode(uint16_t cw_angle_limit, uint16_t ccw_angle_limit)
+    {
+        if (0 == cw_angle_limit && 0 == ccw_angle_limit)
+            return OperatingMode::wheel;
+        else if (4095 == cw_angle_limit && 4095 == ccw_angle_limit)
+            return OperatingMode::multi_turn;
+        else
+            return OperatingMode::joint;
+    }
+
+    /// Operating mode of a Protocol2 actuator, given its operating_mode field
+    inline OperatingMode operating_mode_value2mode(uint8_t mode)
+    {
+        if (0 == mode)
+            return OperatingMode::torque;
+        if (1 == mode)
+            return OperatingMode::wheel;
+        else if (2 == mode)
+            return OperatingMode::joint;
+        else if (3 == mode)
+            return OperatingMode::joint;
+        else if (4 == mode)
+            return OperatingMode::multi_turn;
+        else
+            return OperatingMode::unknown;
+    }
+
     /**
         @throws errors since this function uses other parts of the library, it may
             relay an exception raised during its operation.
@@ -44,12 +77,23 @@ namespace dynamixel {
         }
         Protocol1::unpack_data(status.parameters(), ccw_angle_limit);
 
-        if (0 == cw_angle_limit && 0 == ccw_angle_limit)
-            return OperatingMode::wheel;
-        else if (4095 == cw_angle_limit && 4095 == ccw_angle_limit)
-            return OperatingMode::multi_turn;
-        else
-            return OperatingMode::joint;
+        return angle_limits2mode(cw_angle_limit, ccw_angle_limit);
+    }
+
+    /** Operating mode of a Protocol1 actuator, from its cached angle limits.
+
+        The EEPROM area of the actuator is read (once) if it is not cached yet.
+
+        @throws errors::Error if the actuator had to be read and did not answer
+    **/
+    template <class Controller>
+    inline OperatingMode operating_mode_p1(
+        Controller& controller,
+        typename Protocol1::id_t id,
+        EepromCache<Protocol1>& cache)
+    {
+        return angle_limits2mode(cache.get<uint16_t>(controller, id, 6),
+            cache.get<uint16_t>(controller, id, 8));
     }
 
     /**
@@ -75,18 +119,23 @@ namespace dynamixel {
         }
         Protocol2::unpack_data(status.parameters(), mode);
 
-        if (0 == mode)
-            return OperatingMode::torque;
-        if (1 == mode)
-            return OperatingMode::wheel;
-        else if (2 == mode)
-            return OperatingMode::joint;
-        else if (3 == mode)
-            return OperatingMode::joint;
-        else if (4 == mode)
-            return OperatingMode::multi_turn;
-        else
-            return OperatingMode::unknown;
+        return operating_mode_value2mode(mode);
+    }
+
+    /** Operating mode of a Protocol2 actuator, from its cached operating_mode
+        field.
+
+        The EEPROM area of the actuator is read (once) if it is not cached yet.
+
+        @throws errors::Error if the actuator had to be read and did not answer
+    **/
+    template <class Controller>
+    inline OperatingMode operating_mode_p2(
+        Controller& controller,
+        typename Protocol2::id_t id,
+        EepromCache<Protocol2>& cache)
+    {
+        return operating_mode_value2mode(cache.get<uint8_t>(controller, id, 11));
     }
 
     /** Query an actuator for its operating mode.
@@ -104,6 +153,153 @@ namespace dynamixel {
             return operating_mode_p2(controller, id);
     }
 
+    /** Query an actuator for its operating mode, through an EEPROM cache.
+
+        Querying the operating mode of an actuator again does not send any
+        packet, as long as the cache is not invalidated.
+
+        @see operating_mode(Controller&, typename Protocol::id_t)
+    **/
+    template <class Controller>
+    OperatingMode operating_mode(Controller& controller, typename Protocol1::id_t id, EepromCache<Protocol1>& cache)
+    {
+        return operating_mode_p1(controller, id, cache);
+    }
+
+    /// @see operating_mode(Controller&, typename Protocol1::id_t, EepromCache<Protocol1>&)
+    template <class Controller>
+    OperatingMode operating_mode(Controller& controller, typename Protocol2::id_t id, EepromCache<Protocol2>& cache)
+    {
+        return operating_mode_p2(controller, id, cache);
+    }
+
+    /** Operating mode of several Protocol1 actuators, with a single bulk read
+        of their angle limits (addresses 6 to 9).
+
+        The bulk read instruction is only understood by the MX series (and the
+        models of the same generation); the actuators that did not answer it
+        (like the AX series) are then read one by one, with one Read each.
+
+        @param controller object handling the USB to dynamixel interface
+        @param ids identifiers of the actuators
+        @param statuses status of the read, for each actuator (output)
+        @return operating mode of each actuator, in the order of ids;
+            OperatingMode::unknown for those that did not answer properly
+    **/
+    template <class Controller>
+    inline std::vector<OperatingMode> operating_modes_p1(
+        Controller& controller,
+        const std::vector<typename Protocol1::id_t>& ids,
+        std::vector<ReadStatus>& statuses)
+    {
+        std::vector<OperatingMode> modes(ids.size(), OperatingMode::unknown);
+        statuses.assign(ids.size(), ReadStatus::timeout);
+        if (ids.empty())
+            return modes;
+
+        // decode the angle limits of actuator i
+        auto on_reply = [&modes, &statuses](size_t i, const StatusPacket<Protocol1>& status) {
+            const std::vector<uint8_t>& parameters = status.parameters();
+            if (parameters.size() != 4) {
+                statuses[i] = ReadStatus::size_mismatch;
+                return;
+            }
+            uint16_t cw_angle_limit, ccw_angle_limit;
+            Protocol1::unpack_data(parameters.data(), parameters.size(), 0, cw_angle_limit);
+            Protocol1::unpack_data(parameters.data(), parameters.size(), 2, ccw_angle_limit);
+            modes[i] = angle_limits2mode(cw_angle_limit, ccw_angle_limit);
+            statuses[i] = (0 == status.error_byte()) ? ReadStatus::ok : ReadStatus::servo_error;
+        };
+
+        controller.send(instructions::BulkRead<Protocol1>(
+            std::vector<Protocol1::address_t>(ids.size(), 6), ids,
+            std::vector<uint8_t>(ids.size(), 4)));
+
+        recv_replies<Protocol1>(controller, ids, on_reply,
+            [&statuses](size_t i, ReadStatus read_status) {
+                statuses[i] = read_status;
+            });
+
+        // actuators that do not know the bulk read instruction
+        for (size_t i = 0; i < ids.size(); ++i) {
+            if (ReadStatus::timeout != statuses[i])
+                continue;
+            controller.send(instructions::Read<Protocol1>(ids[i], 6, 4));
+            recv_replies<Protocol1>(controller, std::vector<Protocol1::id_t>(1, ids[i]),
+                [&on_reply, i](size_t, const StatusPacket<Protocol1>& status) {
+                    on_reply(i, status);
+                },
+                [&statuses, i](size_t, ReadStatus read_status) {
+                    statuses[i] = read_status;
+                });
+        }
+
+        return modes;
+    }
+
+    /** Operating mode of several Protocol2 actuators, with a single sync read
+        of their operating_mode field (address 11).
+
+        @see operating_modes_p1
+    **/
+    template <class Controller>
+    inline std::vector<OperatingMode> operating_modes_p2(
+        Controller& controller,
+        const std::vector<typename Protocol2::id_t>& ids,
+        std::vector<ReadStatus>& statuses)
+    {
+        std::vector<OperatingMode> modes(ids.size(), OperatingMode::unknown);
+        statuses.assign(ids.size(), ReadStatus::timeout);
+        if (ids.empty())
+            return modes;
+
+        controller.send(instructions::SyncRead<Protocol2>(11, 1, ids));
+
+        recv_replies<Protocol2>(controller, ids,
+            [&modes, &statuses](size_t i, const StatusPacket<Protocol2>& status) {
+                if (status.parameters().size() != 1) {
+                    statuses[i] = ReadStatus::size_mismatch;
+                    return;
+                }
+                modes[i] = operating_mode_value2mode(status.parameters()[0]);
+                statuses[i] = (0 == status.error_byte()) ? ReadStatus::ok : ReadStatus::servo_error;
+            },
+            [&statuses](size_t i, ReadStatus read_status) {
+                statuses[i] = read_status;
+            });
+
+        return modes;
+    }
+
+    /** Query several actuators for their operating mode, with a single
+        instruction (bulk read for Protocol1, sync read for Protocol2); the
+        Protocol1 actuators that do not answer the bulk read are read one by
+        one.
+
+        No exception is thrown when an actuator does not answer; its mode is
+        OperatingMode::unknown and the reason is given in statuses.
+
+        @see operating_mode(Controller&, typename Protocol::id_t)
+    **/
+    template <class Protocol, class Controller>
+    std::vector<OperatingMode> operating_modes(Controller& controller,
+        const std::vector<typename Protocol::id_t>& ids, std::vector<ReadStatus>& statuses)
+    {
+        if (1 == Protocol::version)
+            return operating_modes_p1(controller, ids, statuses);
+        else
+            return operating_modes_p2(controller, ids, statuses);
+    }
+
+    /// @see operating_modes(Controller&, const std::vector<typename Protocol::id_t>&, std::vector<ReadStatus>&)
+    template <class Protocol, class Controller>
+    std::vector<OperatingMode> operating_modes(Controller& controller,
+        const std::vector<typename Protocol::id_t>& ids)
+    {
+        std::vector<ReadStatus> statuses;
+        return operating_modes<Protocol>(controller, ids, statuses);
+    }
+
     /// Give the string name for an operating mode
     std::string mode2str(OperatingMode mode)
     {
@@ -0,0 +1,178 @@
+#ifndef DYNAMIXEL_PIPELINE_HPP_
+#define DYNAMIXEL_PIPELINE_HPP_
+
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+
+#include "errors/error.hpp"
+#include "instruction_packet.hpp"
+#include "protocols/decode_report.hpp"
+#include "read_result.hpp"
+#include "send_queue.hpp"
+#include "status_packet.hpp"
+
+namespace dynamixel {
+    /** Queue of transactions (an instruction, and possibly the reply of one
+        actuator) executed without idle time on the host side.
+
+        All the packets are encoded when they are submitted, so that the next
+        request goes out as soon as the bus is free; the packets that do not
+        trigger a reply are sent along with the next request, in the same
+        write (see SendQueue). The replies are matched to the outstanding
+        requests by the id of the actuator, not by their order.
+
+            TransactionPipeline<Protocol1> pipeline;
+            pipeline.submit(goal_positions); // sync write, no reply
+            size_t a = pipeline.submit(Read<Protocol1>(1, 36, 2), 1);
+            size_t b = pipeline.submit(Read<Protocol1>(2, 36, 2), 2);
+            pipeline.run(controller, replies, statuses);
+            // replies[a], statuses[a]...
+
+        The bus is half-duplex, so by default a request is only sent once the
+        reply of the previous one arrived (or timed out): one transaction is
+        in flight. More transactions may be in flight (see
+        set_max_in_flight) when the actuators' return delay time covers the
+        transmission of the following requests and the replies cannot
+        overlap; otherwise the replies collide on the bus. There is never more
+        than one outstanding request per actuator.
+
+        The buses of a BusManager are independent: each one can run its own
+        pipeline in the same cycle.
+    **/
+    template <class Protocol>
+    class TransactionPipeline {
+    public:
+        typedef typename Protocol::id_t id_t;
+
+        TransactionPipeline() : _max_in_flight(1) {}
+
+        /// Maximum number of requests whose reply is awaited at the same time
+        size_t max_in_flight() const { return _max_in_flight; }
+
+        /// @see max_in_flight; it must be at least 1
+        void set_max_in_flight(size_t max_in_flight)
+        {
+            if (0 == max_in_flight)
+                throw errors::Error("TransactionPipeline: at least one transaction has to be in flight");
+            _max_in_flight = max_in_flight;
+        }
+
+        /** Queue an instruction to which no actuator replies.
+
+            @return index of the transaction, in the replies and statuses
+        **/
+        size_t submit(const InstructionPacket<Protocol>& packet)
+        {
+            _Transaction transaction = {packet, false, 0};
+            _transactions.push_back(transaction);
+            return _transactions.size() - 1;
+        }
+
+        /** Queue an instruction to which the actuator reply_id replies.
+
+            @return index of the transaction, in the replies and statuses
+        **/
+        size_t submit(const InstructionPacket<Protocol>& packet, id_t reply_id)
+        {
+            _Transaction transaction = {packet, true, reply_id};
+            _transactions.push_back(transaction);
+            return _transactions.size() - 1;
+        }
+
+        /// Number of queued transactions
+        size_t size() const { return _transactions.size(); }
+
+        void clear() { _transactions.clear(); }
+
+        /** Execute all the queued transactions, and empty the queue.
+
+            No exception is thrown for errors that are specific to one actuator;
+            they are reported in statuses. A transaction without reply has the
+            status ReadStatus::ok once it was sent.
+
+            @param controller object handling the USB to dynamixel interface
+            @param replies reply of each transaction, in the order of `submit`
+            @param statuses status of each transaction
+            @return number of writes on the bus
+        **/
+        template <typename Controller>
+        size_t run(const Controller& controller, std::vector<StatusPacket<Protocol>>& replies,
+            std::vector<ReadStatus>& statuses)
+        {
+            replies.assign(_transactions.size(), StatusPacket<Protocol>());
+            statuses.assign(_transactions.size(), ReadStatus::timeout);
+
+            SendQueue<Protocol> queue;
+            // transactions waiting for their reply
+            std::vector<size_t> in_flight;
+            size_t next = 0, writes = 0;
+            StatusPacket<Protocol> status;
+            protocols::DecodeReport report;
+
+            while (next < _transactions.size() || !in_flight.empty()) {
+                while (next < _transactions.size() && in_flight.size() < _max_in_flight
+                    && !_awaited(in_flight, _transactions[next])) {
+                    queue.push(_transactions[next].packet);
+                    if (_transactions[next].reply)
+                        in_flight.push_back(next);
+                    else
+                        statuses[next] = ReadStatus::ok;
+                    ++next;
+                }
+                if (!queue.empty()) {
+                    queue.flush(controller);
+                    ++writes;
+                }
+                if (in_flight.empty())
+                    continue;
+
+                if (!controller.recv(status, report)) {
+                    // the outstanding requests will not be answered anymore
+                    for (size_t i = 0; i < in_flight.size(); ++i)
+                        statuses[in_flight[i]] = (report.error == protocols::DecodeError::checksum)
+                            ? ReadStatus::checksum_error
+                            : ReadStatus::timeout;
+                    in_flight.clear();
+                    continue;
+                }
+
+                // a reply from an actuator that is not awaited is dropped
+                for (size_t i = 0; i < in_flight.size(); ++i) {
+                    if (_transactions[in_flight[i]].reply_id == status.id()) {
+                        replies[in_flight[i]] = status;
+                        statuses[in_flight[i]] = (0 == status.error_byte()) ? ReadStatus::ok : ReadStatus::servo_error;
+                        in_flight.erase(in_flight.begin() + i);
+                        break;
+                    }
+                }
+            }
+
+            _transactions.clear();
+            return writes;
+        }
+
+    protected:
+        struct _Transaction {
+            InstructionPacket<Protocol> packet;
+            bool reply;
+            id_t reply_id;
+        };
+
+        // whether the actuator replying to transaction already has a request in flight
+        bool _awaited(const std::vector<size_t>& in_flight, const _Transaction& transaction) const
+        {
+            if (!transaction.reply)
+                return false;
+            for (size_t i = 0; i < in_flight.size(); ++i)
+                if (_transactions[in_flight[i]].reply_id == transaction.reply_id)
+                    return true;
+            return false;
+        }
+
+        std::vector<_Transaction> _transactions;
+        size_t _max_in_flight;
+    };
+} // namespace dynamixel
+
+#endif
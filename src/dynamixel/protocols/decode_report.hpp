@@ -0,0 +1,54 @@
+#ifndef DYNAMIXEL_PROTOCOLS_DECODE_REPORT_HPP_
+#define DYNAMIXEL_PROTOCOLS_DECODE_REPORT_HPP_
+
+#include <stdint.h>
+
+namespace dynamixel {
+    namespace protocols {
+        /** Reason for which the non-throwing decoder (`decode_status`) rejected
+            or flagged a status packet.
+        **/
+        enum class DecodeError {
+            none,
+            bad_header,
+            bad_length,
+            checksum,
+            servo_error
+        };
+
+        /** Details about the decoding of a status packet, filled by
+            `decode_status` in place of an exception.
+
+            When `error` is `DecodeError::servo_error`, the packet is complete
+            and valid; the actuator merely raised some of the bits of its error
+            field (`error_byte`). The human-readable explanation can be built on
+            demand with `Protocol::status_error_message`.
+        **/
+        struct DecodeReport {
+            DecodeReport()
+                : error(DecodeError::none), error_byte(0),
+                  expected_checksum(0), received_checksum(0),
+                  discarded_checksum(false) {}
+
+            void clear()
+            {
+                error = DecodeError::none;
+                error_byte = 0;
+                expected_checksum = 0;
+                received_checksum = 0;
+                discarded_checksum = false;
+            }
+
+            DecodeError error;
+            // raw content of the error field of the status packet
+            uint8_t error_byte;
+            // only meaningful when error is DecodeError::checksum
+            uint32_t expected_checksum, received_checksum;
+            // set by the controllers when a packet with a checksum mismatch
+            // was discarded while waiting for this one
+            bool discarded_checksum;
+        };
+    } // namespace protocols
+} // namespace dynamixel
+
+#endif
@@ -2,14 +2,18 @@
 #define DYNAMIXEL_PROTOCOLS_PROTOCOL1_HPP_
 
 #include <cassert>
+#include <new> // for std::nothrow
 #include <sstream>
 #include <stdint.h>
+#include <string>
+#include <type_traits>
 #include <vector>
 
 #include "../errors/bad_packet.hpp"
 #include "../errors/crc_error.hpp"
 #include "../errors/status_error.hpp"
 #include "../errors/unpack_error.hpp"
+#include "decode_report.hpp"
 
 namespace dynamixel {
     namespace protocols {
@@ -25,6 +29,11 @@ namespace dynamixel {
 
             static const id_t broadcast_id = 0xFE;
 
+            // bytes before the parameters, in an instruction packet
+            static constexpr size_t instruction_header_size = 5;
+            // bytes after the parameters, in an instruction packet
+            static constexpr size_t checksum_size = 1;
+
             struct Instructions {
                 static const instr_t ping = 0x01;
                 static const instr_t read = 0x02;
@@ -87,6 +96,47 @@ namespace dynamixel {
                 return packet;
             }
 
+            /** Write the header of an instruction packet (everything before the
+                parameters) at the beginning of a buffer.
+
+                This, along with `finalize_checksum`, allows to build a packet
+                directly in a buffer that is reused from one packet to the next.
+
+                @param packet destination, of at least instruction_header_size bytes
+                @param id id of the target actuator
+                @param instr instruction code
+                @param parameters_size number of bytes of parameters that will
+                    follow the header
+                @return number of bytes written (instruction_header_size)
+            **/
+            static size_t write_instruction_header(uint8_t* packet, id_t id, instr_t instr, size_t parameters_size)
+            {
+                packet[0] = 0xFF;
+                packet[1] = 0xFF;
+                packet[2] = id;
+                packet[3] = (uint8_t)(parameters_size + 2);
+                packet[4] = instr;
+
+                return instruction_header_size;
+            }
+
+            /** Compute the checksum of an instruction packet whose header and
+                parameters are already in the buffer, and write it right after
+                the parameters.
+
+                @param packet buffer holding the packet, with checksum_size bytes
+                    available after the parameters
+                @param parameters_size number of bytes of parameters
+                @return total size of the packet
+            **/
+            static size_t finalize_checksum(uint8_t* packet, size_t parameters_size)
+            {
+                size_t size = instruction_header_size + parameters_size;
+                packet[size] = _checksum(packet, size);
+
+                return size + checksum_size;
+            }
+
             static std::vector<uint8_t> pack_data(uint8_t data)
             {
                 std::vector<uint8_t> packed(1);
@@ -114,18 +164,135 @@ namespace dynamixel {
                                     "implemented in Protocol1");
             }
 
-            static void unpack_data(const std::vector<uint8_t>& packet, uint8_t& res)
+            /** Encode a value in a buffer provided by the caller, without any
+                allocation.
+
+                The data is written in little-endian order, on sizeof(T) bytes.
+                T can be any of the 8, 16 or 32 bits integer types (signed or
+                unsigned).
+
+                Contrary to the std::vector version, the 32 bits integers are
+                accepted, even though the control tables of protocol 1 have no
+                such field.
+
+                @param data value to be encoded
+                @param buffer destination; there must be at least sizeof(T)
+                    bytes available from offset
+                @param offset index, in buffer, of the first byte to be written
+                @return number of bytes written
+            **/
+            template <typename T>
+            static size_t pack_data(T data, uint8_t* buffer, size_t offset = 0)
+            {
+                static_assert(std::is_integral<T>::value && sizeof(T) <= 4,
+                    "pack_data: only 8, 16 and 32 bits integers are supported");
+                typedef typename std::make_unsigned<T>::type unsigned_t;
+
+                for (size_t i = 0; i < sizeof(T); ++i)
+                    buffer[offset + i] = (uint8_t)((((unsigned_t)data) >> (8 * i)) & 0xFF);
+
+                return sizeof(T);
+            }
+
+            /** Decode a value at a given position of a buffer, without copying
+                it and without throwing.
+
+                This is meant to decode one field from the middle of a larger
+                read (for instance one covering several fields).
+
+                @param buffer data received from the actuator
+                @param size number of bytes in buffer
+                @param offset index, in buffer, of the first byte of the value
+                @param res decoded value, only modified on success
+                @return false if the buffer is too short
+            **/
+            template <typename T>
+            static bool unpack_data(const uint8_t* buffer, size_t size, size_t offset, T& res, const std::nothrow_t&)
+            {
+                static_assert(std::is_integral<T>::value && sizeof(T) <= 4,
+                    "unpack_data: only 8, 16 and 32 bits integers are supported");
+                typedef typename std::make_unsigned<T>::type unsigned_t;
+
+                if (offset > size || size - offset < sizeof(T))
+                    return false;
+
+                unsigned_t value = 0;
+                for (size_t i = 0; i < sizeof(T); ++i)
+                    value |= ((unsigned_t)buffer[offset + i]) << (8 * i);
+                res = (T)value;
+
+                return true;
+            }
+
+            /** Decode a value at a given position of a buffer.
+
+                @see unpack_data(const uint8_t*, size_t, size_t, T&, const std::nothrow_t&)
+
+                @throws errors::UnpackError if the buffer is too short
+            **/
+            template <typename T>
+            static void unpack_data(const uint8_t* buffer, size_t size, size_t offset, T& res)
+            {
+                if (!unpack_data(buffer, size, offset, res, std::nothrow))
+                    throw errors::UnpackError(1, offset < size ? size - offset : 0, sizeof(T));
+            }
+
+            /** Decode a value at a given position of the parameters of a status
+                packet.
+
+                @see unpack_data(const uint8_t*, size_t, size_t, T&)
+            **/
+            template <typename T>
+            static void unpack_data(const std::vector<uint8_t>& packet, size_t offset, T& res)
+            {
+                unpack_data(packet.data(), packet.size(), offset, res);
+            }
+
+            /** Decode a value from the parameters of a status packet, without
+                throwing.
+
+                @param packet parameters of the status packet
+                @param res decoded value, only modified on success
+                @return false if the size of packet does not match the one of res
+            **/
+            static bool unpack_data(const std::vector<uint8_t>& packet, uint8_t& res, const std::nothrow_t&)
             {
                 if (packet.size() != 1)
-                    throw errors::UnpackError(1, packet.size(), 1);
+                    return false;
                 res = packet[0];
+                return true;
             }
 
-            static void unpack_data(const std::vector<uint8_t>& packet, uint16_t& res)
+            static bool unpack_data(const std::vector<uint8_t>& packet, uint16_t& res, const std::nothrow_t&)
             {
                 if (packet.size() != 2)
-                    throw errors::UnpackError(1, packet.size(), 2);
+                    return false;
                 res = (((uint16_t)packet[1]) << 8) | ((uint16_t)packet[0]);
+                return true;
+            }
+
+            static bool unpack_data(const std::vector<uint8_t>& packet, uint32_t& res, const std::nothrow_t&)
+            {
+                // 32 bits fields do not exist for protocol 1
+                return false;
+            }
+
+            static bool unpack_data(const std::vector<uint8_t>& packet, int32_t& res, const std::nothrow_t&)
+            {
+                // 32 bits fields do not exist for protocol 1
+                return false;
+            }
+
+            static void unpack_data(const std::vector<uint8_t>& packet, uint8_t& res)
+            {
+                if (!unpack_data(packet, res, std::nothrow))
+                    throw errors::UnpackError(1, packet.size(), 1);
+            }
+
+            static void unpack_data(const std::vector<uint8_t>& packet, uint16_t& res)
+            {
+                if (!unpack_data(packet, res, std::nothrow))
+                    throw errors::UnpackError(1, packet.size(), 2);
             }
 
             static void unpack_data(const std::vector<uint8_t>& packet, uint32_t& res)
@@ -140,27 +307,32 @@ namespace dynamixel {
                                     "implemented in Protocol1");
             }
 
-            /** Decodes the content of a status packet received from the servos
+            /** Decodes the content of a status packet received from the servos,
+                without throwing any exception.
 
-            This method is only used by the StatusPacket class, to make it
-            independent of the protocol version.
+                Contrary to unpack_status, an error reported by the actuator
+                does not prevent the decoding: the packet is DONE, its
+                parameters are filled and report.error is set to
+                DecodeError::servo_error, with the raw error field in
+                report.error_byte. The explanatory message is only built if
+                requested, through status_error_message.
 
-            @param packet content of the received packet
-            @param id id of the sending actuator
-            @param parameters parameters of the status packet, filled by unpack_status
-            @param throw_exceptions boolean telling to throw exceptions if the
-                packet is malformed
-
-            @return the state of the packet unpacking
+                @param packet content of the received packet
+                @param id id of the sending actuator
+                @param parameters parameters of the status packet, filled by
+                    decode_status
+                @param report details on the reason why the packet was rejected
+                    (INVALID) or on the error reported by the actuator (DONE)
 
-            @see unpack_status in protocol2.hpp
+                @return the state of the packet unpacking
             **/
             static DecodeState
-            unpack_status(const std::vector<uint8_t>& packet, id_t& id, std::vector<uint8_t>& parameters, bool throw_exceptions = false)
+            decode_status(const std::vector<uint8_t>& packet, id_t& id, std::vector<uint8_t>& parameters, DecodeReport& report)
             {
+                report.clear();
+
                 if (!detect_status_header(packet)) {
-                    if (throw_exceptions)
-                        throw errors::BadPacket(packet, "Bad packet header");
+                    report.error = DecodeError::bad_header;
                     return INVALID;
                 }
 
@@ -174,12 +346,7 @@ namespace dynamixel {
                 // in the packet itself
                 length_t length = packet[3];
                 if (length < 2) {
-                    if (throw_exceptions) {
-                        std::stringstream message;
-                        message << "Declared packet length (";
-                        message << (int32_t)length << ") is too small.";
-                        throw errors::BadPacket(packet, message.str().c_str());
-                    }
+                    report.error = DecodeError::bad_length;
                     return INVALID;
                 }
                 if (length > packet.size() - 4)
@@ -188,43 +355,103 @@ namespace dynamixel {
                 // Compute checksum and compare with the one we received
                 uint8_t checksum = _checksum(packet);
                 if (checksum != packet.back()) {
-                    if (throw_exceptions)
-                        throw errors::CrcError(id, 1, checksum, packet.back());
+                    report.error = DecodeError::checksum;
+                    report.expected_checksum = checksum;
+                    report.received_checksum = packet.back();
                     return INVALID;
                 }
 
-                uint8_t error = packet[4];
-
-                if (error != 0) {
-                    std::stringstream err_message;
-                    err_message << "Actuator with ID " << ((int32_t)id)
-                                << " reported the following error(s): ";
-                    if (error & 1) // bit 0
-                        err_message << "Input voltage error, ";
-                    if (error & 2) // bit 1
-                        err_message << "Angle limit error, ";
-                    if (error & 4) // bit 2
-                        err_message << "Overheating error, ";
-                    if (error & 8) // bit 3
-                        err_message << "Range error, ";
-                    if (error & 16) // bit 4
-                        err_message << "Checksum error, ";
-                    if (error & 32) // bit 5
-                        err_message << "Overload error, ";
-                    if (error & 64) // bit 6
-                        err_message << "Instruction error, ";
-
-                    throw errors::StatusError(id, 1, error,
-                        err_message.str().substr(0, err_message.str().length() - 2));
-                }
+                parameters.assign(packet.begin() + 5, packet.begin() + 5 + (length - 2));
 
-                parameters.clear();
-                for (size_t i = 0; i < length - 2; ++i)
-                    parameters.push_back(packet[5 + i]);
+                report.error_byte = packet[4];
+                if (report.error_byte != 0)
+                    report.error = DecodeError::servo_error;
 
                 return DONE;
             }
 
+            /** Decodes the content of a status packet received from the servos
+
+            This method is only used by the StatusPacket class, to make it
+            independent of the protocol version. It relies on decode_status
+            and turns the problems it reports into exceptions.
+
+            @param packet content of the received packet
+            @param id id of the sending actuator
+            @param parameters parameters of the status packet, filled by unpack_status
+            @param throw_exceptions boolean telling to throw exceptions if the
+                packet is malformed
+
+            @return the state of the packet unpacking
+
+            @throws errors::StatusError if the actuator reported an error (even
+                if throw_exceptions is false)
+
+            @see unpack_status in protocol2.hpp
+            **/
+            static DecodeState
+            unpack_status(const std::vector<uint8_t>& packet, id_t& id, std::vector<uint8_t>& parameters, bool throw_exceptions = false)
+            {
+                DecodeReport report;
+                DecodeState state = decode_status(packet, id, parameters, report);
+
+                switch (report.error) {
+                case DecodeError::none:
+                    break;
+                case DecodeError::bad_header:
+                    if (throw_exceptions)
+                        throw errors::BadPacket(packet, "Bad packet header");
+                    break;
+                case DecodeError::bad_length:
+                    if (throw_exceptions) {
+                        std::stringstream message;
+                        message << "Declared packet length (";
+                        message << (int32_t)packet[3] << ") is too small.";
+                        throw errors::BadPacket(packet, message.str().c_str());
+                    }
+                    break;
+                case DecodeError::checksum:
+                    if (throw_exceptions)
+                        throw errors::CrcError(id, 1, report.expected_checksum, report.received_checksum);
+                    break;
+                case DecodeError::servo_error:
+                    throw errors::StatusError(id, 1, report.error_byte,
+                        status_error_message(id, report.error_byte));
+                }
+
+                return state;
+            }
+
+            /** Build the explanation for the error field of a status packet.
+
+                @param id id of the actuator that sent the status packet
+                @param error_byte raw error field of the status packet
+
+                @return human-readable message listing the reported errors
+            **/
+            static std::string status_error_message(id_t id, uint8_t error_byte)
+            {
+                std::stringstream err_message;
+                err_message << "Actuator with ID " << ((int32_t)id)
+                            << " reported the following error(s): ";
+                if (error_byte & 1) // bit 0
+                    err_message << "Input voltage error, ";
+                if (error_byte & 2) // bit 1
+                    err_message << "Angle limit error, ";
+                if (error_byte & 4) // bit 2
+                    err_message << "Overheating error, ";
+                if (error_byte & 8) // bit 3
+                    err_message << "Range error, ";
+                if (error_byte & 16) // bit 4
+                    err_message << "Checksum error, ";
+                if (error_byte & 32) // bit 5
+                    err_message << "Overload error, ";
+                if (error_byte & 64) // bit 6
+                    err_message << "Instruction error, ";
+
+                return err_message.str().substr(0, err_message.str().length() - 2);
+            }
+
         protected:
             /** Check if the packet contains a header.
 
@@ -248,8 +475,14 @@ namespace dynamixel {
             {
                 if (packet.size() == 0)
                     throw errors::Error("Checksum (protocol 1): cannot compute checksum, the packet is empty");
+                return _checksum(packet.data(), packet.size() - 1);
+            }
+
+            // checksum of the packet's first `size` bytes (header included)
+            static uint8_t _checksum(const uint8_t* packet, size_t size)
+            {
                 int sum = 0;
-                for (size_t i = 2; i < packet.size() - 1; ++i)
+                for (size_t i = 2; i < size; ++i)
                     sum += packet[i];
                 uint8_t checksum = (sum & 0xFF);
                 if (!(sum > 255) && (sum != checksum))
@@ -4,10 +4,16 @@
 #include <stdint.h>
 #include <vector>
 #include <cassert>
+#include <new> // for std::nothrow
 #include <sstream>
+#include <string>
+#include <type_traits>
 
+#include "../errors/bad_packet.hpp"
 #include "../errors/crc_error.hpp"
 #include "../errors/status_error.hpp"
+#include "../errors/unpack_error.hpp"
+#include "decode_report.hpp"
 
 namespace dynamixel {
     namespace protocols {
@@ -23,6 +29,11 @@ namespace dynamixel {
 
             static const id_t broadcast_id = 0xFE;
 
+            // bytes before the parameters, in an instruction packet
+            static constexpr size_t instruction_header_size = 8;
+            // bytes after the parameters, in an instruction packet
+            static constexpr size_t checksum_size = 2;
+
             struct Instructions {
                 static const instr_t ping = 0x01;
                 static const instr_t read = 0x02;
@@ -100,6 +111,76 @@ namespace dynamixel {
                 return packet;
             }
 
+            /** Write the header of an instruction packet (everything before the
+                parameters) at the beginning of a buffer.
+
+                This, along with `finalize_checksum`, allows to build a packet
+                directly in a buffer that is reused from one packet to the next.
+
+                @param packet destination, of at least instruction_header_size bytes
+                @param id id of the target actuator
+                @param instr instruction code
+                @param parameters_size number of bytes of parameters that will
+                    follow the header
+                @return number of bytes written (instruction_header_size)
+            **/
+            static size_t write_instruction_header(uint8_t* packet, id_t id, instr_t instr, size_t parameters_size)
+            {
+                packet[0] = 0xFF;
+                packet[1] = 0xFF;
+                packet[2] = 0xFD;
+                packet[3] = 0x00;
+                packet[4] = id;
+                packet[5] = (uint8_t)((parameters_size + 3) & 0xFF);
+                packet[6] = (uint8_t)(((parameters_size + 3) >> 8) & 0xFF);
+                packet[7] = instr;
+
+                return instruction_header_size;
+            }
+
+            /** Compute the CRC of an instruction packet whose header and
+                parameters are already in the buffer, and write it right after
+                the parameters.
+
+                @param packet buffer holding the packet, with checksum_size bytes
+                    available after the parameters
+                @param parameters_size number of bytes of parameters
+                @return total size of the packet
+            **/
+            static size_t finalize_checksum(uint8_t* packet, size_t parameters_size)
+            {
+                size_t size = instruction_header_size + parameters_size;
+                uint16_t checksum = _checksum(packet, size);
+                packet[size] = (uint8_t)(checksum & 0xFF);
+                packet[size + 1] = (uint8_t)((checksum >> 8) & 0xFF);
+
+                return size + checksum_size;
+            }
+
+            /** Update a CRC with a sequence of bytes.
+
+                The CRC of a packet can be computed in several steps, by giving
+                the CRC of the previous bytes as crc_accum; this allows to only
+                recompute the end of a packet whose beginning did not change.
+
+                @param data bytes to be added to the CRC
+                @param size number of bytes
+                @param crc_accum CRC of the bytes preceding data (0 at the
+                    beginning of the packet)
+                @return CRC of all the bytes, data included
+            **/
+            static uint16_t crc(const uint8_t* data, size_t size, uint16_t crc_accum = 0)
+            {
+                const uint16_t* crc_table = _crc_table();
+
+                for (size_t j = 0; j < size; j++) {
+                    uint16_t i = ((uint16_t)(crc_accum >> 8) ^ data[j]) & 0xFF;
+                    crc_accum = (crc_accum << 8) ^ crc_table[i];
+                }
+
+                return crc_accum;
+            }
+
             static std::vector<uint8_t> pack_data(uint8_t data)
             {
                 std::vector<uint8_t> packed(1);
@@ -135,44 +216,159 @@ namespace dynamixel {
                 return packed;
             }
 
-            static void unpack_data(const std::vector<uint8_t>& packet, uint8_t& res)
+            /** Encode a value in a buffer provided by the caller, without any
+                allocation.
+
+                The data is written in little-endian order, on sizeof(T) bytes.
+                T can be any of the 8, 16 or 32 bits integer types (signed or
+                unsigned).
+
+                @param data value to be encoded
+                @param buffer destination; there must be at least sizeof(T)
+                    bytes available from offset
+                @param offset index, in buffer, of the first byte to be written
+                @return number of bytes written
+            **/
+            template <typename T>
+            static size_t pack_data(T data, uint8_t* buffer, size_t offset = 0)
+            {
+                static_assert(std::is_integral<T>::value && sizeof(T) <= 4,
+                    "pack_data: only 8, 16 and 32 bits integers are supported");
+                typedef typename std::make_unsigned<T>::type unsigned_t;
+
+                for (size_t i = 0; i < sizeof(T); ++i)
+                    buffer[offset + i] = (uint8_t)((((unsigned_t)data) >> (8 * i)) & 0xFF);
+
+                return sizeof(T);
+            }
+
+            /** Decode a value at a given position of a buffer, without copying
+                it and without throwing.
+
+                This is meant to decode one field from the middle of a larger
+                read (for instance one covering several fields).
+
+                @param buffer data received from the actuator
+                @param size number of bytes in buffer
+                @param offset index, in buffer, of the first byte of the value
+                @param res decoded value, only modified on success
+                @return false if the buffer is too short
+            **/
+            template <typename T>
+            static bool unpack_data(const uint8_t* buffer, size_t size, size_t offset, T& res, const std::nothrow_t&)
+            {
+                static_assert(std::is_integral<T>::value && sizeof(T) <= 4,
+                    "unpack_data: only 8, 16 and 32 bits integers are supported");
+                typedef typename std::make_unsigned<T>::type unsigned_t;
+
+                if (offset > size || size - offset < sizeof(T))
+                    return false;
+
+                unsigned_t value = 0;
+                for (size_t i = 0; i < sizeof(T); ++i)
+                    value |= ((unsigned_t)buffer[offset + i]) << (8 * i);
+                res = (T)value;
+
+                return true;
+            }
+
+            /** Decode a value at a given position of a buffer.
+
+                @see unpack_data(const uint8_t*, size_t, size_t, T&, const std::nothrow_t&)
+
+                @throws errors::UnpackError if the buffer is too short
+            **/
+            template <typename T>
+            static void unpack_data(const uint8_t* buffer, size_t size, size_t offset, T& res)
+            {
+                if (!unpack_data(buffer, size, offset, res, std::nothrow))
+                    throw errors::UnpackError(2, offset < size ? size - offset : 0, sizeof(T));
+            }
+
+            /** Decode a value at a given position of the parameters of a status
+                packet.
+
+                @see unpack_data(const uint8_t*, size_t, size_t, T&)
+            **/
+            template <typename T>
+            static void unpack_data(const std::vector<uint8_t>& packet, size_t offset, T& res)
+            {
+                unpack_data(packet.data(), packet.size(), offset, res);
+            }
+
+            /** Decode a value from the parameters of a status packet, without
+                throwing.
+
+                @see unpack_data in protocol1.hpp
+            **/
+            static bool unpack_data(const std::vector<uint8_t>& packet, uint8_t& res, const std::nothrow_t&)
             {
                 if (packet.size() != 1)
-                    throw errors::UnpackError(2, packet.size(), 1);
+                    return false;
                 res = packet[0];
+                return true;
             }
 
-            static void unpack_data(const std::vector<uint8_t>& packet, uint16_t& res)
+            static bool unpack_data(const std::vector<uint8_t>& packet, uint16_t& res, const std::nothrow_t&)
             {
                 if (packet.size() != 2)
-                    throw errors::UnpackError(2, packet.size(), 2);
+                    return false;
                 res = (((uint16_t)packet[1]) << 8) | ((uint16_t)packet[0]);
+                return true;
             }
 
-            static void unpack_data(const std::vector<uint8_t>& packet, uint32_t& res)
+            static bool unpack_data(const std::vector<uint8_t>& packet, uint32_t& res, const std::nothrow_t&)
             {
                 if (packet.size() != 4)
-                    throw errors::UnpackError(2, packet.size(), 4);
+                    return false;
                 res = (((uint32_t)packet[3]) << 24) | (((uint32_t)packet[2]) << 16) | (((uint32_t)packet[1]) << 8) | ((uint32_t)packet[0]);
+                return true;
             }
 
-            static void unpack_data(const std::vector<uint8_t>& packet, int32_t& res)
+            static bool unpack_data(const std::vector<uint8_t>& packet, int32_t& res, const std::nothrow_t&)
             {
                 if (packet.size() != 4)
-                    throw errors::UnpackError(2, packet.size(), 4);
+                    return false;
                 res = (((int32_t)packet[3]) << 24) | (((int32_t)packet[2]) << 16) | (((int32_t)packet[1]) << 8) | ((int32_t)packet[0]);
+                return true;
             }
 
-            /** Decodes the content of a status packet received from the servos
+            static void unpack_data(const std::vector<uint8_t>& packet, uint8_t& res)
+            {
+                if (!unpack_data(packet, res, std::nothrow))
+                    throw errors::UnpackError(2, packet.size(), 1);
+            }
 
-                @see unpack_status in protocol1.hpp
+            static void unpack_data(const std::vector<uint8_t>& packet, uint16_t& res)
+            {
+                if (!unpack_data(packet, res, std::nothrow))
+                    throw errors::UnpackError(2, packet.size(), 2);
+            }
+
+            static void unpack_data(const std::vector<uint8_t>& packet, uint32_t& res)
+            {
+                if (!unpack_data(packet, res, std::nothrow))
+                    throw errors::UnpackError(2, packet.size(), 4);
+            }
+
+            static void unpack_data(const std::vector<uint8_t>& packet, int32_t& res)
+            {
+                if (!unpack_data(packet, res, std::nothrow))
+                    throw errors::UnpackError(2, packet.size(), 4);
+            }
+
+            /** Decodes the content of a status packet received from the servos,
+                without throwing any exception.
+
+                @see decode_status in protocol1.hpp
             **/
             static DecodeState
-            unpack_status(const std::vector<uint8_t>& packet, id_t& id, std::vector<uint8_t>& parameters, bool throw_exceptions = false)
+            decode_status(const std::vector<uint8_t>& packet, id_t& id, std::vector<uint8_t>& parameters, DecodeReport& report)
             {
+                report.clear();
+
                 if (!detect_status_header(packet)) {
-                    if (throw_exceptions)
-                        throw errors::BadPacket(packet, "Bad packet header");
+                    report.error = DecodeError::bad_header;
                     return INVALID;
                 }
 
@@ -188,12 +384,7 @@ namespace dynamixel {
                 // in the packet itself
                 length_t length = (((uint16_t)packet[6]) << 8) | packet[5];
                 if (length < 4) {
-                    if (throw_exceptions) {
-                        std::stringstream message;
-                        message << "Declared packet length (";
-                        message << (int32_t)length << ") is too small.";
-                        throw errors::BadPacket(packet, message.str().c_str());
-                    }
+                    report.error = DecodeError::bad_length;
                     return INVALID;
                 }
                 if (length != packet.size() - 7)
@@ -207,52 +398,96 @@ namespace dynamixel {
                 uint16_t checksum = _checksum(packet);
                 uint16_t recv_checksum = (((uint16_t)packet.back()) << 8) | packet[packet.size() - 2];
                 if (checksum != recv_checksum) {
-                    if (throw_exceptions)
-                        throw errors::CrcError(id, 2, checksum, recv_checksum);
+                    report.error = DecodeError::checksum;
+                    report.expected_checksum = checksum;
+                    report.received_checksum = recv_checksum;
                     return INVALID;
                 }
 
-                uint8_t error = packet[8];
-
-                if (error != 0) {
-                    std::stringstream err_message;
-                    err_message << "Actuator with ID " << ((int32_t)id)
-                                << " reported the following error: ";
-                    if (error & 0x80)
-                        err_message << "Device alert, check Hardware Error field from Control Table; ";
-
-                    switch (error & 0x7F) {
-                    case 0x01:
-                        err_message << "Result fail";
-                        break;
-                    case 0x02:
-                        err_message << "Instruction error";
-                        break;
-                    case 0x03:
-                        err_message << "CRC error";
-                        break;
-                    case 0x04:
-                        err_message << "Data range error";
-                        break;
-                    case 0x05:
-                        err_message << "Data length error";
-                        break;
-                    case 0x06:
-                        err_message << "Data limit error";
-                        break;
-                    case 0x07:
-                        err_message << "Access error";
-                        break;
-                    }
+                parameters.assign(packet.begin() + 9, packet.begin() + 9 + (length - 4));
+
+                report.error_byte = packet[8];
+                if (report.error_byte != 0)
+                    report.error = DecodeError::servo_error;
+
+                return DONE;
+            }
 
-                    throw errors::StatusError(id, 2, error, err_message.str());
+            /** Decodes the content of a status packet received from the servos
+
+                @see unpack_status in protocol1.hpp
+            **/
+            static DecodeState
+            unpack_status(const std::vector<uint8_t>& packet, id_t& id, std::vector<uint8_t>& parameters, bool throw_exceptions = false)
+            {
+                DecodeReport report;
+                DecodeState state = decode_status(packet, id, parameters, report);
+
+                switch (report.error) {
+                case DecodeError::none:
+                    break;
+                case DecodeError::bad_header:
+                    if (throw_exceptions)
+                        throw errors::BadPacket(packet, "Bad packet header");
+                    break;
+                case DecodeError::bad_length:
+                    if (throw_exceptions) {
+                        std::stringstream message;
+                        message << "Declared packet length (";
+                        message << (int32_t)((((uint16_t)packet[6]) << 8) | packet[5])
+                                << ") is too small.";
+                        throw errors::BadPacket(packet, message.str().c_str());
+                    }
+                    break;
+                case DecodeError::checksum:
+                    if (throw_exceptions)
+                        throw errors::CrcError(id, 2, report.expected_checksum, report.received_checksum);
+                    break;
+                case DecodeError::servo_error:
+                    throw errors::StatusError(id, 2, report.error_byte,
+                        status_error_message(id, report.error_byte));
                 }
 
-                parameters.clear();
-                for (size_t i = 0; i < length - 4; ++i)
-                    parameters.push_back(packet[9 + i]);
+                return state;
+            }
 
-                return DONE;
+            /** Build the explanation for the error field of a status packet.
+
+                @see status_error_message in protocol1.hpp
+            **/
+            static std::string status_error_message(id_t id, uint8_t error_byte)
+            {
+                std::stringstream err_message;
+                err_message << "Actuator with ID " << ((int32_t)id)
+                            << " reported the following error: ";
+                if (error_byte & 0x80)
+                    err_message << "Device alert, check Hardware Error field from Control Table; ";
+
+                switch (error_byte & 0x7F) {
+                case 0x01:
+                    err_message << "Result fail";
+                    break;
+                case 0x02:
+                    err_message << "Instruction error";
+                    break;
+                case 0x03:
+                    err_message << "CRC error";
+                    break;
+                case 0x04:
+                    err_message << "Data range error";
+                    break;
+                case 0x05:
+                    err_message << "Data length error";
+                    break;
+                case 0x06:
+                    err_message << "Data limit error";
+                    break;
+                case 0x07:
+                    err_message << "Access error";
+                    break;
+                }
+
+                return err_message.str();
             }
 
         protected:
@@ -280,9 +515,19 @@ namespace dynamixel {
             {
                 if (packet.size() == 0)
                     throw errors::Error("Checksum (protocol 2): cannot compute checksum, the packet is empty");
-                uint16_t crc_accum = 0;
+                return _checksum(packet.data(), packet.size() - 2);
+            }
 
-                uint16_t crc_table[256] = {
+            // CRC of the first `size` bytes of a packet (header included)
+            static uint16_t _checksum(const uint8_t* packet, size_t size)
+            {
+                return crc(packet, size);
+            }
+
+            // lookup table of the CRC, for the polynomial 0x8005
+            static const uint16_t* _crc_table()
+            {
+                static const uint16_t crc_table[256] = {
                     0x0000, 0x8005, 0x800F, 0x000A, 0x801B, 0x001E, 0x0014, 0x8011, 0x8033,
                     0x0036, 0x003C, 0x8039, 0x0028, 0x802D, 0x8027, 0x0022, 0x8063, 0x0066,
                     0x006C, 0x8069, 0x0078, 0x807D, 0x8077, 0x0072, 0x0050, 0x8055, 0x805F,
@@ -313,12 +558,7 @@ namespace dynamixel {
                     0x022A, 0x823B, 0x023E, 0x0234, 0x8231, 0x8213, 0x0216, 0x021C, 0x8219,
                     0x0208, 0x820D, 0x8207, 0x0202};
 
-                for (size_t j = 0; j < packet.size() - 2; j++) {
-                    uint16_t i = ((uint16_t)(crc_accum >> 8) ^ packet[j]) & 0xFF;
-                    crc_accum = (crc_accum << 8) ^ crc_table[i];
-                }
-
-                return crc_accum;
+                return crc_table;
             }
         };
     } // namespace protocols
@@ -0,0 +1,206 @@
+#ifndef DYNAMIXEL_READ_PLAN_HPP_
+#define DYNAMIXEL_READ_PLAN_HPP_
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "errors/error.hpp"
+#include "errors/unpack_error.hpp"
+#include "instructions/read.hpp"
+#include "status_packet.hpp"
+
+namespace dynamixel {
+    /** Location of a field in a control table.
+
+        The fields of a model are given by `Model::field_<name>()`, for
+        instance `servos::Mx28::field_present_position()`.
+    **/
+    template <class Protocol>
+    struct Field {
+        constexpr Field(typename Protocol::address_t address, typename Protocol::length_t size)
+            : address(address), size(size) {}
+
+        typename Protocol::address_t address;
+        typename Protocol::length_t size;
+    };
+
+    /** Contiguous range of the control table, covered by a single read.
+    **/
+    template <class Protocol>
+    struct ReadRange {
+        typename Protocol::address_t address;
+        typename Protocol::length_t length;
+        // position of the data of this range in the plan's payload
+        size_t offset;
+    };
+
+    /** Read of several fields of one actuator, with as few instructions as
+        possible.
+
+        The fields are merged into contiguous ranges of the control table;
+        each range is read with a single Read instruction (or could be one entry
+        of a bulk read), and each field is then decoded, without copy, from the
+        data received for its range.
+
+            ReadPlan<Protocol1> plan;
+            size_t position = plan.add(Mx28::field_present_position());
+            size_t speed = plan.add(Mx28::field_present_speed());
+            size_t load = plan.add(Mx28::field_present_load());
+            plan.read(controller, id); // a single Read, of 6 bytes
+            uint16_t p = plan.get<Mx28::ct_t::present_position_t>(position);
+
+        Two fields are merged if the gap between them is at most `max_gap`
+        bytes (zero by default: only adjacent or overlapping fields are merged).
+        A larger gap reads a few useless bytes but saves round trips.
+    **/
+    template <class Protocol>
+    class ReadPlan {
+    public:
+        typedef typename Protocol::address_t address_t;
+        typedef typename Protocol::length_t length_t;
+
+        explicit ReadPlan(size_t max_gap = 0) : _max_gap(max_gap), _planned(true) {}
+
+        /** Add a field to be read.
+
+            @param field address and size of the field
+            @return index of the field, to be given to `get`
+        **/
+        size_t add(const Field<Protocol>& field)
+        {
+            _fields.push_back(field);
+            _field_offsets.push_back(0);
+            _planned = false;
+            return _fields.size() - 1;
+        }
+
+        size_t add(address_t address, length_t size)
+        {
+            return add(Field<Protocol>(address, size));
+        }
+
+        /// Merged ranges, in increasing order of address
+        const std::vector<ReadRange<Protocol>>& ranges()
+        {
+            _plan();
+            return _ranges;
+        }
+
+        /// Read instructions for one actuator, one per range
+        std::vector<instructions::Read<Protocol>> packets(typename Protocol::id_t id)
+        {
+            _plan();
+            std::vector<instructions::Read<Protocol>> result;
+            for (size_t i = 0; i < _ranges.size(); ++i)
+                result.push_back(instructions::Read<Protocol>(id, _ranges[i].address, _ranges[i].length));
+            return result;
+        }
+
+        /** Store the data received in reply to the read of a range.
+
+            @param range index of the range (in `ranges()`)
+            @param data parameters of the status packet
+            @throws errors::UnpackError if the size does not match the range
+        **/
+        void set_data(size_t range, const std::vector<uint8_t>& data)
+        {
+            _plan();
+            const ReadRange<Protocol>& r = _ranges.at(range);
+            if (data.size() != r.length)
+                throw errors::UnpackError(Protocol::version, data.size(), r.length);
+            std::copy(data.begin(), data.end(), _payload.begin() + r.offset);
+        }
+
+        /** Read all the ranges from one actuator.
+
+            @param controller object handling the USB to dynamixel interface
+            @param id identifier of the actuator
+            @throws errors::Error if the actuator does not answer
+        **/
+        template <typename Controller>
+        void read(const Controller& controller, typename Protocol::id_t id)
+        {
+            _plan();
+            StatusPacket<Protocol> status;
+            for (size_t i = 0; i < _ranges.size(); ++i) {
+                controller.send(instructions::Read<Protocol>(id, _ranges[i].address, _ranges[i].length));
+                if (!controller.recv(status))
+                    throw errors::Error("ReadPlan: no answer from the actuator");
+                set_data(i, status.parameters());
+            }
+        }
+
+        /** Decode the value of a field from the received data.
+
+            @param field index returned by `add`
+            @return value of the field, decoded on sizeof(T) bytes
+        **/
+        template <typename T>
+        T get(size_t field)
+        {
+            _plan();
+            T value;
+            Protocol::unpack_data(_payload.data(), _payload.size(), _field_offsets.at(field), value);
+            return value;
+        }
+
+        size_t size() const { return _fields.size(); }
+
+    protected:
+        void _plan()
+        {
+            if (_planned)
+                return;
+
+            std::vector<size_t> order(_fields.size());
+            for (size_t i = 0; i < order.size(); ++i)
+                order[i] = i;
+            std::sort(order.begin(), order.end(), _AddressOrder(_fields));
+
+            _ranges.clear();
+            // end (excluded) of the current range
+            size_t end = 0;
+            for (size_t k = 0; k < order.size(); ++k) {
+                const Field<Protocol>& field = _fields[order[k]];
+                size_t field_end = (size_t)field.address + field.size;
+
+                if (_ranges.empty() || field.address > end + _max_gap) {
+                    ReadRange<Protocol> range;
+                    range.address = field.address;
+                    range.length = field.size;
+                    range.offset = _ranges.empty() ? 0 : _ranges.back().offset + _ranges.back().length;
+                    _ranges.push_back(range);
+                    end = field_end;
+                }
+                else if (field_end > end) {
+                    end = field_end;
+                    _ranges.back().length = (length_t)(end - _ranges.back().address);
+                }
+
+                _field_offsets[order[k]] = _ranges.back().offset + (field.address - _ranges.back().address);
+            }
+
+            _payload.assign(_ranges.empty() ? 0 : _ranges.back().offset + _ranges.back().length, 0);
+            _planned = true;
+        }
+
+        struct _AddressOrder {
+            explicit _AddressOrder(const std::vector<Field<Protocol>>& fields) : fields(fields) {}
+            bool operator()(size_t a, size_t b) const { return fields[a].address < fields[b].address; }
+            const std::vector<Field<Protocol>>& fields;
+        };
+
+        size_t _max_gap;
+        bool _planned;
+        std::vector<Field<Protocol>> _fields;
+        // position of each field in _payload
+        std::vector<size_t> _field_offsets;
+        std::vector<ReadRange<Protocol>> _ranges;
+        // data of all the ranges, one after the other
+        std::vector<uint8_t> _payload;
+    };
+} // namespace dynamixel
+
+#endif
@@ -0,0 +1,192 @@
+#ifndef DYNAMIXEL_READ_RESULT_HPP_
+#define DYNAMIXEL_READ_RESULT_HPP_
+
+#include <new> // for std::nothrow
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "protocols/decode_report.hpp"
+#include "status_packet.hpp"
+
+namespace dynamixel {
+    /// Outcome of the read of one actuator, within a batched read
+    enum class ReadStatus {
+        ok,
+        timeout,
+        checksum_error,
+        servo_error,
+        size_mismatch
+    };
+
+    /** Value read from one actuator, along with the status of this read.
+
+        When status is ReadStatus::servo_error, the actuator did answer and the
+        value is available, but the actuator raised some bits of its error
+        field (like an overload or overheating alert), that can be found in
+        error_byte. For the other statuses but ReadStatus::ok, value is not
+        meaningful.
+    **/
+    template <typename Protocol, typename T>
+    struct ReadResult {
+        ReadResult() : id(0), value(0), status(ReadStatus::timeout), error_byte(0) {}
+
+        explicit ReadResult(typename Protocol::id_t id)
+            : id(id), value(0), status(ReadStatus::timeout), error_byte(0) {}
+
+        /// The value is available (ok or servo_error)
+        bool has_value() const
+        {
+            return ReadStatus::ok == status || ReadStatus::servo_error == status;
+        }
+
+        bool ok() const
+        {
+            return ReadStatus::ok == status;
+        }
+
+        typename Protocol::id_t id;
+        T value;
+        ReadStatus status;
+        uint8_t error_byte;
+    };
+
+    /// Give the string name for a read status
+    inline std::string status2str(ReadStatus status)
+    {
+        switch (status) {
+        case ReadStatus::ok:
+            return "ok";
+        case ReadStatus::timeout:
+            return "timeout";
+        case ReadStatus::checksum_error:
+            return "checksum error";
+        case ReadStatus::servo_error:
+            return "servo error";
+        case ReadStatus::size_mismatch:
+        default:
+            return "size mismatch";
+        }
+    }
+
+    /** Fill a ReadResult from a status packet that was received (without
+        throwing).
+
+        @param status status packet received from the actuator
+        @param result the value, status and error byte are set here
+    **/
+    template <typename Protocol, typename T>
+    inline void parse_result(const StatusPacket<Protocol>& status,
+        ReadResult<Protocol, T>& result)
+    {
+        result.error_byte = status.error_byte();
+        if (!Protocol::unpack_data(status.parameters(), result.value, std::nothrow))
+            result.status = ReadStatus::size_mismatch;
+        else if (0 != result.error_byte)
+            result.status = ReadStatus::servo_error;
+        else
+            result.status = ReadStatus::ok;
+    }
+
+    /** Wait for the replies of several actuators to one or more read
+        instructions, without throwing on errors that are specific to one
+        actuator.
+
+        The replies are expected in the order of the ids (like for the bulk
+        and sync read instructions). A missing reply is reported with the
+        ReadStatus::timeout status (or ReadStatus::checksum_error if a corrupted
+        packet was discarded meanwhile, even when the controller went on to
+        receive the next reply), and does not prevent to gather the
+        following ones. Once the bus stays silent for the receive timeout,
+        though, no other reply is waited for: the actuators of a bulk or sync
+        read answer one after the other, and all the replies that are still
+        expected are reported as timeouts.
+
+        @param controller object handling the USB to dynamixel interface
+        @param ids ids of the actuators, in the order of the expected replies
+        @param on_reply called as on_reply(index, status_packet) for each reply
+            received, index being the position of the actuator in ids
+        @param on_missing called as on_missing(index, read_status) for each
+            actuator that did not reply
+    **/
+    template <typename Protocol, typename Controller, typename OnReply, typename OnMissing>
+    inline void recv_replies(const Controller& controller,
+        const std::vector<typename Protocol::id_t>& ids,
+        OnReply on_reply, OnMissing on_missing)
+    {
+        size_t next = 0;
+        StatusPacket<Protocol> status;
+        protocols::DecodeReport report;
+        while (next < ids.size()) {
+            if (!controller.recv(status, report)) {
+                if (report.error == protocols::DecodeError::checksum) {
+                    on_missing(next, ReadStatus::checksum_error);
+                    ++next;
+                    continue;
+                }
+                // silence: the next actuators will not answer either
+                for (; next < ids.size(); ++next)
+                    on_missing(next, ReadStatus::timeout);
+                break;
+            }
+
+            // look for the actuator that replied, among the remaining ones;
+            // the previous ones will not answer anymore (their reply may be
+            // the corrupted packet that the controller skipped)
+            const ReadStatus skipped = report.discarded_checksum
+                ? ReadStatus::checksum_error
+                : ReadStatus::timeout;
+            for (size_t i = next; i < ids.size(); ++i) {
+                if (ids[i] == status.id()) {
+                    for (size_t j = next; j < i; ++j)
+                        on_missing(j, skipped);
+                    on_reply(i, status);
+                    next = i + 1;
+                    break;
+                }
+            }
+        }
+    }
+
+    /** Collect the replies of several actuators to one or more read
+        instructions, as ReadResults.
+
+        @see recv_replies
+
+        @param controller object handling the USB to dynamixel interface
+        @param ids ids of the actuators, in the order of the expected replies
+        @return one result per id, in the same order
+    **/
+    template <typename T, typename Protocol, typename Controller>
+    inline std::vector<ReadResult<Protocol, T>>
+    recv_results(const Controller& controller,
+        const std::vector<typename Protocol::id_t>& ids)
+    {
+        std::vector<ReadResult<Protocol, T>> results(ids.begin(), ids.end());
+
+        recv_replies<Protocol>(controller, ids,
+            [&results](size_t i, const StatusPacket<Protocol>& status) {
+                parse_result(status, results[i]);
+            },
+            [&results](size_t i, ReadStatus read_status) {
+                results[i].status = read_status;
+            });
+
+        return results;
+    }
+
+    /** Wait for the reply of one actuator, without throwing on errors that
+        are specific to this actuator.
+
+        @see recv_results
+    **/
+    template <typename T, typename Protocol, typename Controller>
+    inline ReadResult<Protocol, T>
+    recv_result(const Controller& controller, typename Protocol::id_t id)
+    {
+        return recv_results<T, Protocol>(controller,
+            std::vector<typename Protocol::id_t>(1, id))[0];
+    }
+} // namespace dynamixel
+
+#endif
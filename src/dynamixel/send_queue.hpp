@@ -0,0 +1,150 @@
+#ifndef DYNAMIXEL_SEND_QUEUE_HPP_
+#define DYNAMIXEL_SEND_QUEUE_HPP_
+
+#include <stdint.h>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "instruction_packet.hpp"
+#include "read_result.hpp"
+#include "status_packet.hpp"
+
+namespace dynamixel {
+    /** Packets sent together, with a single call to the controller's send (so
+        a single `write` on the serial port, and as few USB frames as
+        possible), and the replies they are expecting.
+
+            SendQueue<Protocol1> queue;
+            queue.push(goal_positions); // sync write, no reply
+            queue.push(moving_speeds); // sync write, no reply
+            queue.push(Read<Protocol1>(1, Mx28::ct_t::present_position, 2), 1);
+            queue.exchange(controller, replies, statuses); // one write
+
+        The bus is half-duplex: an actuator replies as soon as it received its
+        instruction (after its return delay time), even if the next packets of
+        the queue are still being sent. Only expect replies from the
+        actuators that will not answer while the queue is sent: typically the
+        last packet of the queue, or actuators whose return delay time is long
+        enough. The other packets should not trigger replies (sync or bulk
+        writes, broadcast, or status return level set accordingly).
+    **/
+    template <class Protocol>
+    class SendQueue {
+    public:
+        typedef typename Protocol::id_t id_t;
+
+        SendQueue() : _size(0) {}
+
+        /// Queue a packet to which no actuator replies
+        void push(const InstructionPacket<Protocol>& packet)
+        {
+            _buffer.insert(_buffer.end(), packet.data(), packet.data() + packet.size());
+            ++_size;
+        }
+
+        /// Queue a packet to which the actuator reply_id replies
+        void push(const InstructionPacket<Protocol>& packet, id_t reply_id)
+        {
+            push(packet);
+            _replies.push_back(reply_id);
+        }
+
+        /// Queue a packet built at compile time (see instructions::StaticPackets)
+        template <size_t N>
+        void push(const std::array<uint8_t, N>& packet)
+        {
+            _buffer.insert(_buffer.end(), packet.begin(), packet.end());
+            ++_size;
+        }
+
+        /// @see push(const std::array<uint8_t, N>&), with a reply of reply_id
+        template <size_t N>
+        void push(const std::array<uint8_t, N>& packet, id_t reply_id)
+        {
+            push(packet);
+            _replies.push_back(reply_id);
+        }
+
+        /// Number of packets not sent yet
+        size_t size() const { return _size; }
+
+        bool empty() const { return 0 == _size; }
+
+        /// Bytes of the packets not sent yet
+        const std::vector<uint8_t>& buffer() const { return _buffer; }
+
+        /// Ids of the actuators whose reply was not received yet, in order
+        const std::vector<id_t>& expected_replies() const { return _replies; }
+
+        /// Drop the packets and the expected replies
+        void clear()
+        {
+            _buffer.clear();
+            _replies.clear();
+            _size = 0;
+        }
+
+        /** Send all the queued packets at once.
+
+            The expected replies are kept, to be received by `recv`.
+
+            @param controller object handling the USB to dynamixel interface
+            @return number of packets sent
+        **/
+        template <typename Controller>
+        size_t flush(const Controller& controller)
+        {
+            size_t sent = _size;
+            if (!_buffer.empty())
+                controller.send(_buffer.data(), _buffer.size());
+            _buffer.clear();
+            _size = 0;
+            return sent;
+        }
+
+        /** Receive the replies expected from the packets already sent, in the
+            order of the packets.
+
+            No exception is thrown for errors that are specific to one actuator;
+            they are reported in statuses (@see recv_replies).
+
+            @param controller object handling the USB to dynamixel interface
+            @param replies status packet of each expected reply
+            @param statuses status of each expected reply
+        **/
+        template <typename Controller>
+        void recv(const Controller& controller, std::vector<StatusPacket<Protocol>>& replies,
+            std::vector<ReadStatus>& statuses)
+        {
+            replies.assign(_replies.size(), StatusPacket<Protocol>());
+            statuses.assign(_replies.size(), ReadStatus::timeout);
+
+            recv_replies<Protocol>(controller, _replies,
+                [&replies, &statuses](size_t i, const StatusPacket<Protocol>& status) {
+                    replies[i] = status;
+                    statuses[i] = (0 == status.error_byte()) ? ReadStatus::ok : ReadStatus::servo_error;
+                },
+                [&statuses](size_t i, ReadStatus status) {
+                    statuses[i] = status;
+                });
+            _replies.clear();
+        }
+
+        /// Send the queued packets and receive their replies (@see flush, recv)
+        template <typename Controller>
+        void exchange(const Controller& controller, std::vector<StatusPacket<Protocol>>& replies,
+            std::vector<ReadStatus>& statuses)
+        {
+            flush(controller);
+            recv(controller, replies, statuses);
+        }
+
+    protected:
+        std::vector<uint8_t> _buffer;
+        std::vector<id_t> _replies;
+        size_t _size;
+    };
+} // namespace dynamixel
+
+#endif
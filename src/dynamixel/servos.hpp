@@ -25,4 +25,6 @@
 #include "servos/pro_l54_50_s500.hpp"
 #include "servos/pro_l42_10_s300.hpp"
 
+#include "servos/servo_group.hpp"
+
 #endif
@@ -99,6 +99,11 @@ namespace dynamixel {
 
             MODEL_NAME(Ax12W);
 
+            static constexpr bool bulk_read_support()
+            {
+                return false;
+            }
+
             // Here we add the fields that are not common to all dynamixels
             READ_WRITE_FIELD(cw_angle_limit);
             READ_WRITE_FIELD(ccw_angle_limit);
@@ -1,8 +1,11 @@
 #ifndef DYNAMIXEL_SERVOS_BASE_SERVO_HPP_
 #define DYNAMIXEL_SERVOS_BASE_SERVO_HPP_
 
+#include <vector>
+
 #include "../instruction_packet.hpp"
 #include "../errors/error.hpp"
+#include "../read_plan.hpp"
 
 #define BASE_FIELD(Name)                                                         \
     virtual InstructionPacket<protocol_t> get_##Name() const                     \
@@ -55,6 +58,13 @@ namespace dynamixel {
                 throw errors::Error("model_name not implemented in model");
             }
 
+            // Number of bytes of the EEPROM area, from address 0, as kept by
+            // an EepromCache
+            virtual size_t eeprom_size() const
+            {
+                throw errors::Error("eeprom_size not implemented in model");
+            }
+
             // All the memory addresses of all the models need to be declared here
             // Then, the concrete model classes override the ones that they have
 
@@ -211,6 +221,57 @@ namespace dynamixel {
                 throw errors::Error("parse_joint_speed not implemented in model");
             }
 
+            // =================================================================
+            // Batched operations: location of the fields and encoding of the
+            // values, so that actuators of different models can be grouped in
+            // sync and bulk instructions (see BatchWrite and BatchRead)
+
+            virtual Field<protocol_t> goal_position_field() const
+            {
+                throw errors::Error("goal_position_field not implemented in model");
+            }
+
+            virtual Field<protocol_t> present_position_field() const
+            {
+                throw errors::Error("present_position_field not implemented in model");
+            }
+
+            virtual Field<protocol_t> moving_speed_field() const
+            {
+                throw errors::Error("moving_speed_field not implemented in model");
+            }
+
+            virtual Field<protocol_t> present_speed_field() const
+            {
+                throw errors::Error("present_speed_field not implemented in model");
+            }
+
+            virtual Field<protocol_t> torque_enable_field() const
+            {
+                throw errors::Error("torque_enable_field not implemented in model");
+            }
+
+            // Whether the actuator answers the bulk and sync read instructions
+            // (BatchRead reads the other ones individually)
+            virtual bool supports_bulk_read() const
+            {
+                throw errors::Error("supports_bulk_read not implemented in model");
+            }
+
+            // Bytes of the goal_position field for an angle (rad), with the
+            // same checks as set_goal_position_angle
+            virtual std::vector<uint8_t> goal_position_angle_data(double rad) const
+            {
+                throw errors::Error("goal_position_angle_data not implemented in model");
+            }
+
+            // Bytes of the moving_speed field for a speed (rad/s), with the
+            // same checks as set_moving_speed_angle
+            virtual std::vector<uint8_t> moving_speed_angle_data(double rad_per_s, OperatingMode operating_mode = OperatingMode::joint) const
+            {
+                throw errors::Error("moving_speed_angle_data not implemented in model");
+            }
+
         protected:
             BaseServo() {}
         };
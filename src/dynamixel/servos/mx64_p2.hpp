@@ -128,6 +128,12 @@ namespace dynamixel {
                 typedef uint16_t present_voltage_t;
                 static const protocol_t::address_t present_temperature = 146;
                 typedef uint8_t present_temperature_t;
+                // indirect addresses (28 entries) and the data they point to
+                static const protocol_t::address_t indirect_address = 168;
+                typedef uint16_t indirect_address_t;
+                static const protocol_t::address_t indirect_data = 224;
+                typedef uint8_t indirect_data_t;
+                static const protocol_t::length_t indirect_count = 28;
             };
         };
 
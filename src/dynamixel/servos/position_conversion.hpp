@@ -0,0 +1,98 @@
+#ifndef DYNAMIXEL_SERVOS_POSITION_CONVERSION_HPP_
+#define DYNAMIXEL_SERVOS_POSITION_CONVERSION_HPP_
+
+#include <stdint.h>
+#include <cstddef>
+
+#include "model_traits.hpp"
+
+namespace dynamixel {
+    namespace servos {
+        /** Batch conversions between angles (in radians) and positions in the
+            units of the control table (ticks), for one model.
+
+            The scale and offset are computed once per model, and the loops
+            have no branch nor function call, so that the compiler can
+            vectorize them. Contrary to Servo::set_goal_position_angle, the
+            values out of the model's limits do not throw: they are clamped and
+            reported in a separate array, so that all the joints are handled.
+        **/
+        template <class Model>
+        struct PositionConversion {
+            typedef typename ModelTraits<Model>::CT ct_t;
+            typedef typename ct_t::goal_position_t goal_position_t;
+            typedef typename ct_t::present_position_t present_position_t;
+
+            static constexpr double pi = 3.14159265358979323846;
+
+            /// Lowest goal angle, in radians
+            static constexpr double min_angle() { return ct_t::min_goal_angle_deg * pi / 180.; }
+
+            /// Highest goal angle, in radians
+            static constexpr double max_angle() { return ct_t::max_goal_angle_deg * pi / 180.; }
+
+            /// Number of ticks per radian
+            static constexpr double ticks_per_rad()
+            {
+                return ((double)ct_t::max_goal_position - ct_t::min_goal_position) / (max_angle() - min_angle());
+            }
+
+            /// Position, in ticks, of the angle 0
+            static constexpr double tick_offset()
+            {
+                return ct_t::min_goal_position - min_angle() * ticks_per_rad();
+            }
+
+            /** Convert goal angles to positions.
+
+                @param rad count angles, in radians
+                @param ticks count positions (output)
+                @param violations for each angle, whether it was out of the
+                    limits of the model and was clamped (output)
+                @param count number of values
+                @return number of angles out of the limits
+            **/
+            static size_t to_ticks(const double* rad, goal_position_t* ticks, bool* violations, size_t count)
+            {
+                const double low = min_angle(), high = max_angle();
+                const double scale = ticks_per_rad(), offset = tick_offset();
+                size_t n_violations = 0;
+
+                for (size_t i = 0; i < count; ++i) {
+                    const double r = rad[i];
+                    const bool below = r < low, above = r > high;
+                    const double clamped = below ? low : (above ? high : r);
+                    violations[i] = below || above;
+                    n_violations += below || above;
+                    const double t = clamped * scale + offset;
+                    // rounded to the nearest tick
+                    ticks[i] = (goal_position_t)(t + (t < 0 ? -0.5 : 0.5));
+                }
+
+                return n_violations;
+            }
+
+            /** Convert present positions to angles.
+
+                @param ticks count positions, as read from the actuators
+                @param rad count angles, in radians (output)
+                @param count number of values
+            **/
+            static void to_angles(const present_position_t* ticks, double* rad, size_t count)
+            {
+                const double scale = 1. / ticks_per_rad(), offset = tick_offset();
+
+                for (size_t i = 0; i < count; ++i)
+                    rad[i] = (ticks[i] - offset) * scale;
+            }
+
+            /// Convert one present position to an angle
+            static double to_angle(present_position_t ticks)
+            {
+                return (ticks - tick_offset()) / ticks_per_rad();
+            }
+        };
+    } // namespace servos
+} // namespace dynamixel
+
+#endif
@@ -98,6 +98,12 @@ namespace dynamixel {
                 typedef uint8_t status_return_level_t;
                 static const protocol_t::address_t hardware_error_status = 892;
                 typedef uint8_t hardware_error_status_t;
+                // indirect addresses (256 entries) and the data they point to
+                static const protocol_t::address_t indirect_address = 49;
+                typedef uint16_t indirect_address_t;
+                static const protocol_t::address_t indirect_data = 634;
+                typedef uint8_t indirect_data_t;
+                static const protocol_t::length_t indirect_count = 256;
             };
         };
 
@@ -6,6 +6,7 @@
 #include "../errors/error.hpp"
 #include "../errors/servo_limit_error.hpp"
 #include "../instruction_packet.hpp"
+#include "../instructions/sync_write_builder.hpp"
 #include "../protocols.hpp"
 #include "base_servo.hpp"
 #include "model_traits.hpp"
@@ -58,6 +59,49 @@ namespace dynamixel {
             {
                 throw errors::Error("reg_moving_speed_angle not implemented for this protocol");
             }
+
+            /** Build, in a reusable sync write packet, the desired speeds of
+                several actuators of this model.
+
+                See the protocol-specific implemetnations for details.
+
+                @param builder packet to be (re)built
+                @param ids array of count identifiers
+                @param rad_per_s array of count rotational speeds, in radians
+                    per second
+                @param count number of actuators
+                @param operating_mode (enum) mode in which all the actuators
+                    are controlled
+                @return builder
+            **/
+            static inline instructions::SyncWriteBuilder<P>& set_moving_speeds_angle(
+                instructions::SyncWriteBuilder<P>& builder,
+                const typename P::id_t* ids,
+                const double* rad_per_s,
+                size_t count,
+                OperatingMode operating_mode = OperatingMode::joint)
+            {
+                throw errors::Error("set_moving_speeds_angle not implemented for this protocol");
+            }
+
+            /** Bytes of the moving_speed field of an actuator, for a desired
+                speed.
+
+                See the protocol-specific implemetnations for details.
+
+                @param id identifier of the actuator (for the error messages)
+                @param rad_per_s rotational speed, in radians per second
+                @param operating_mode (enum) mode in which the actuator is
+                    controlled
+                @return the encoded value
+            **/
+            static inline std::vector<uint8_t> moving_speed_angle_data(
+                typename P::id_t id,
+                double rad_per_s,
+                OperatingMode operating_mode = OperatingMode::joint)
+            {
+                throw errors::Error("moving_speed_angle_data not implemented for this protocol");
+            }
         };
 
         template <class M>
@@ -88,6 +132,39 @@ namespace dynamixel {
                 return Servo<M>::reg_moving_speed(id, speed_ticks);
             }
 
+            /** Build, in a reusable sync write packet, the desired speeds of
+                several actuators of this model.
+
+                The speeds are converted like for set_moving_speed_angle: in
+                wheel mode, the negative speeds are encoded with the direction
+                bit; in joint mode, only positive speeds are accepted.
+
+                @throws errors::ServoLimitError for the first speed out of the
+                    actuator's bounds; the packet is then incomplete
+            **/
+            static inline instructions::SyncWriteBuilder<protocols::Protocol1>& set_moving_speeds_angle(
+                instructions::SyncWriteBuilder<protocols::Protocol1>& builder,
+                const typename protocols::Protocol1::id_t* ids,
+                const double* rad_per_s,
+                size_t count,
+                OperatingMode operating_mode)
+            {
+                builder.start(ct_t::moving_speed, sizeof(moving_speed_t), count);
+                for (size_t i = 0; i < count; ++i)
+                    builder.set(i, ids[i], angular_speed_to_ticks(ids[i], rad_per_s[i], operating_mode));
+
+                return builder.finalize();
+            }
+
+            /// Bytes of the moving_speed field, encoded like for set_moving_speed_angle
+            static inline std::vector<uint8_t> moving_speed_angle_data(
+                typename protocols::Protocol1::id_t id,
+                double rad_per_s,
+                OperatingMode operating_mode)
+            {
+                return protocols::Protocol1::pack_data(angular_speed_to_ticks(id, rad_per_s, operating_mode));
+            }
+
         private:
             // 2 * pi
             static constexpr double two_pi = 6.28318;
@@ -154,6 +231,38 @@ namespace dynamixel {
                 return Servo<M>::reg_moving_speed(id, speed_ticks);
             }
 
+            /** Build, in a reusable sync write packet, the desired speeds of
+                several actuators of this model.
+
+                With protocol 2, the speeds are signed and do not depend on the
+                operating mode.
+
+                @throws errors::ServoLimitError for the first speed out of the
+                    actuator's bounds; the packet is then incomplete
+            **/
+            static inline instructions::SyncWriteBuilder<protocols::Protocol2>& set_moving_speeds_angle(
+                instructions::SyncWriteBuilder<protocols::Protocol2>& builder,
+                const typename protocols::Protocol2::id_t* ids,
+                const double* rad_per_s,
+                size_t count,
+                OperatingMode operating_mode)
+            {
+                builder.start(ct_t::moving_speed, sizeof(moving_speed_t), count);
+                for (size_t i = 0; i < count; ++i)
+                    builder.set(i, ids[i], angular_speed_to_ticks(ids[i], rad_per_s[i]));
+
+                return builder.finalize();
+            }
+
+            /// Bytes of the moving_speed field, encoded like for set_moving_speed_angle
+            static inline std::vector<uint8_t> moving_speed_angle_data(
+                typename protocols::Protocol2::id_t id,
+                double rad_per_s,
+                OperatingMode operating_mode)
+            {
+                return protocols::Protocol2::pack_data(angular_speed_to_ticks(id, rad_per_s));
+            }
+
         private:
             // 2 * pi
             static constexpr double two_pi = 6.28318;
@@ -14,8 +14,11 @@
 #include "../instructions/read.hpp"
 #include "../instructions/reboot.hpp"
 #include "../instructions/reg_write.hpp"
+#include "../instructions/static_packets.hpp"
 #include "../instructions/sync_write.hpp"
+#include "../instructions/sync_write_builder.hpp"
 #include "../instructions/write.hpp"
+#include "../read_plan.hpp"
 #include "../status_packet.hpp"
 #include "base_servo.hpp"
 #include "model_traits.hpp"
@@ -33,6 +36,16 @@
         return typename Servo<Model>::read_t(id, Servo<Model>::ct_t::Name, sizeof(typename Servo<Model>::ct_t::Name##_t));                                           \
     }                                                                                                                                                                \
                                                                                                                                                                      \
+    static constexpr typename Servo<Model>::static_packets_t::read_t constexpr_get_##Name(typename Servo<Model>::protocol_t::id_t id)                                \
+    {                                                                                                                                                                \
+        return Servo<Model>::static_packets_t::read(id, Servo<Model>::ct_t::Name, sizeof(typename Servo<Model>::ct_t::Name##_t));                                    \
+    }                                                                                                                                                                \
+                                                                                                                                                                     \
+    static constexpr Field<typename Servo<Model>::protocol_t> field_##Name()                                                                                         \
+    {                                                                                                                                                                \
+        return Field<typename Servo<Model>::protocol_t>(Servo<Model>::ct_t::Name, sizeof(typename Servo<Model>::ct_t::Name##_t));                                    \
+    }                                                                                                                                                                \
+                                                                                                                                                                     \
     static typename Servo<Model>::ct_t::Name##_t parse_##Name(typename Servo<Model>::protocol_t::id_t id, const StatusPacket<typename Servo<Model>::protocol_t>& st) \
     {                                                                                                                                                                \
         typename Servo<Model>::ct_t::Name##_t res;                                                                                                                   \
@@ -100,7 +113,10 @@ namespace dynamixel {
             typedef instructions::Action<protocol_t> action_t;
             typedef instructions::FactoryReset<protocol_t> factory_reset_t;
             typedef instructions::SyncWrite<protocol_t> sync_write_t;
+            typedef instructions::SyncWriteBuilder<protocol_t> sync_write_builder_t;
             typedef instructions::BulkRead<protocol_t> bulk_read_t;
+            // packets computed at compile time
+            typedef instructions::StaticPackets<protocol_t> static_packets_t;
 
             long long int id() const override
             {
@@ -112,6 +128,13 @@ namespace dynamixel {
                 this->_id = static_cast<typename protocol_t::id_t>(id);
             }
 
+            // The EEPROM area ends where the RAM area (torque_enable) begins;
+            // the Pro series only have indirect addresses past the 64th byte
+            size_t eeprom_size() const override
+            {
+                return ct_t::torque_enable < 64 ? ct_t::torque_enable : 64;
+            }
+
             READ_FIELD(model_number);
             READ_FIELD(firmware_version);
             READ_WRITE_FIELD(id);
@@ -145,7 +168,8 @@ namespace dynamixel {
             // =================================================================
             // Position-specific
 
-            static inline InstructionPacket<protocol_t> set_goal_position_angle(typename Servo<Model>::protocol_t::id_t id, double rad)
+            // Convert a goal angle (rad) to a value of the goal_position field
+            static typename ct_t::goal_position_t goal_position_angle_to_ticks(typename Servo<Model>::protocol_t::id_t id, double rad)
             {
                 double deg = rad * 57.2958;
                 if (!(deg >= ct_t::min_goal_angle_deg && deg <= ct_t::max_goal_angle_deg))
@@ -154,22 +178,17 @@ namespace dynamixel {
                         ct_t::min_goal_angle_deg * 0.01745, // convert from deg to rad
                         ct_t::max_goal_angle_deg * 0.01745,
                         rad);
-                typename ct_t::goal_position_t pos = ((deg - ct_t::min_goal_angle_deg) * (ct_t::max_goal_position - ct_t::min_goal_position) / (ct_t::max_goal_angle_deg - ct_t::min_goal_angle_deg)) + ct_t::min_goal_position;
-                return set_goal_position(id, pos);
+                return ((deg - ct_t::min_goal_angle_deg) * (ct_t::max_goal_position - ct_t::min_goal_position) / (ct_t::max_goal_angle_deg - ct_t::min_goal_angle_deg)) + ct_t::min_goal_position;
             }
 
-            static inline InstructionPacket<protocol_t> reg_goal_position_angle(typename Servo<Model>::protocol_t::id_t id, double rad)
+            static inline InstructionPacket<protocol_t> set_goal_position_angle(typename Servo<Model>::protocol_t::id_t id, double rad)
             {
-                double deg = rad * 57.2958;
-                if (!(deg >= ct_t::min_goal_angle_deg && deg <= ct_t::max_goal_angle_deg))
-                    throw errors::ServoLimitError(
-                        id,
-                        ct_t::min_goal_angle_deg * 0.01745,
-                        ct_t::max_goal_angle_deg * 0.01745,
-                        rad);
-                typename ct_t::goal_position_t pos = ((deg - ct_t::min_goal_angle_deg) * (ct_t::max_goal_position - ct_t::min_goal_position) / (ct_t::max_goal_angle_deg - ct_t::min_goal_angle_deg)) + ct_t::min_goal_position;
+                return set_goal_position(id, goal_position_angle_to_ticks(id, rad));
+            }
 
-                return reg_goal_position(id, pos);
+            static inline InstructionPacket<protocol_t> reg_goal_position_angle(typename Servo<Model>::protocol_t::id_t id, double rad)
+            {
+                return reg_goal_position(id, goal_position_angle_to_ticks(id, rad));
             }
 
             InstructionPacket<protocol_t> set_goal_position_angle(double rad) const override
@@ -196,6 +215,12 @@ namespace dynamixel {
             {
                 typename Servo<Model>::ct_t::present_position_t pos;
                 Servo<Model>::protocol_t::unpack_data(st.parameters(), pos);
+                return present_position_to_angle(pos);
+            }
+
+            // Convert a value of the present_position field to radians
+            static double present_position_to_angle(typename Servo<Model>::ct_t::present_position_t pos)
+            {
                 double deg = ((pos - ct_t::min_goal_position) * (ct_t::max_goal_angle_deg - ct_t::min_goal_angle_deg) / (ct_t::max_goal_position - ct_t::min_goal_position)) + ct_t::min_goal_angle_deg;
                 double rad = deg / 57.2958;
                 return rad;
@@ -210,16 +235,36 @@ namespace dynamixel {
             template <typename Id, typename Pos>
             static InstructionPacket<protocol_t> set_goal_positions(const std::vector<Id>& ids, const std::vector<Pos>& pos)
             {
-                std::vector<double> final_pos;
-                for (size_t j = 0; j < pos.size(); j++)
-                    final_pos.push_back(((pos[j] * 57.2958 - ct_t::min_goal_angle_deg) * (ct_t::max_goal_position - ct_t::min_goal_position) / (ct_t::max_goal_angle_deg - ct_t::min_goal_angle_deg)) + ct_t::min_goal_position);
-                if (ids.size() != final_pos.size())
+                if (ids.size() != pos.size())
                     throw errors::Error("Instruction: error when setting goal positions: \n\tMismatch in vector size for ids and positions");
-                std::vector<std::vector<uint8_t>> packed(final_pos.size());
-                for (size_t i = 0; i < final_pos.size(); i++)
-                    packed[i] = protocol_t::pack_data((typename ct_t::goal_position_t)final_pos[i]);
 
-                return sync_write_t(ct_t::goal_position, _get_typed<typename protocol_t::id_t>(ids), packed);
+                sync_write_builder_t builder;
+                set_goal_positions(builder, ids.data(), pos.data(), ids.size());
+                return builder;
+            }
+
+            /** Build, in a reusable sync write packet, the goal positions (in
+                radians) of several actuators of this model.
+
+                No memory is allocated once the builder's buffer is large enough.
+
+                @param builder packet to be (re)built
+                @param ids array of count ids
+                @param pos array of count angles, in radians
+                @param count number of actuators
+                @return builder
+            **/
+            template <typename Id, typename Pos>
+            static sync_write_builder_t& set_goal_positions(sync_write_builder_t& builder,
+                const Id* ids, const Pos* pos, size_t count)
+            {
+                builder.start(ct_t::goal_position, sizeof(typename ct_t::goal_position_t), count);
+                for (size_t i = 0; i < count; i++) {
+                    double final_pos = ((pos[i] * 57.2958 - ct_t::min_goal_angle_deg) * (ct_t::max_goal_position - ct_t::min_goal_position) / (ct_t::max_goal_angle_deg - ct_t::min_goal_angle_deg)) + ct_t::min_goal_position;
+                    builder.set(i, (typename protocol_t::id_t)ids[i], (typename ct_t::goal_position_t)final_pos);
+                }
+
+                return builder.finalize();
             }
 
             // Bulk operations. Only works for MX models with protocol 1. Only works if the models are known and they are all the same
@@ -265,7 +310,12 @@ namespace dynamixel {
             {
                 typename Servo<Model>::ct_t::present_speed_t speed;
                 Servo<Model>::protocol_t::unpack_data(st.parameters(), speed);
+                return present_speed_to_si(speed);
+            }
 
+            // Convert a value of the present_speed field to radians per second
+            static double present_speed_to_si(typename Servo<Model>::ct_t::present_speed_t speed)
+            {
                 int8_t sign;
                 if (Servo<Model>::ct_t::speed_sign_bit) { // the highest bit is used for the sign
                     sign = speed / Servo<Model>::ct_t::max_goal_speed == 0 ? 1 : -1;
@@ -285,45 +335,79 @@ namespace dynamixel {
                 return Model::parse_joint_speed(this->_id, st);
             }
 
+            // =================================================================
+            // Batched operations
+
+            Field<protocol_t> goal_position_field() const override
+            {
+                return Model::field_goal_position();
+            }
+
+            Field<protocol_t> present_position_field() const override
+            {
+                return Model::field_present_position();
+            }
+
+            Field<protocol_t> moving_speed_field() const override
+            {
+                return Model::field_moving_speed();
+            }
+
+            Field<protocol_t> present_speed_field() const override
+            {
+                return Model::field_present_speed();
+            }
+
+            Field<protocol_t> torque_enable_field() const override
+            {
+                return Model::field_torque_enable();
+            }
+
+            // All the models of protocol 2 and the MX series of protocol 1
+            // understand bulk reads; the other models hide this function
+            static constexpr bool bulk_read_support()
+            {
+                return true;
+            }
+
+            bool supports_bulk_read() const override
+            {
+                return Model::bulk_read_support();
+            }
+
+            std::vector<uint8_t> goal_position_angle_data(double rad) const override
+            {
+                return protocol_t::pack_data(Model::goal_position_angle_to_ticks(this->_id, rad));
+            }
+
+            std::vector<uint8_t> moving_speed_angle_data(double rad_per_s, OperatingMode operating_mode = OperatingMode::joint) const override
+            {
+                return ProtocolSpecificPackets<Model, protocol_t>::moving_speed_angle_data(this->_id, rad_per_s, operating_mode);
+            }
+
             // Sync operations. Only works if the models are known and they are all the same
             template <typename Id, typename Speed>
             static InstructionPacket<protocol_t> set_moving_speeds(const std::vector<Id>& ids, const std::vector<Speed>& speeds, OperatingMode operating_mode)
             {
                 if (ids.size() != speeds.size())
                     throw errors::Error("Instruction: error when setting moving speeds: \n\tMismatch in vector size for ids and speeds");
-                std::vector<int32_t> speed_ticks;
-                // convert radians per second to ticks
-                for (int i = 0; i < speeds.size(); i++)
-                    speed_ticks.push_back(round(60 * speeds[i] / (two_pi * ct_t::rpm_per_tick)));
-
-                for (int j = 0; j < speed_ticks.size(); j++) {
-                    // The actuator is operated as a wheel (continuous rotation)
-                    if (operating_mode == OperatingMode::wheel) {
-                        // Check that desired speed is within the actuator's bounds
-
-                        if (!(abs(speed_ticks[j]) >= ct_t::min_goal_speed && abs(speed_ticks[j]) <= ct_t::max_goal_speed)) {
-                            throw errors::Error("Desired speed is out actuator's bounds");
-                        }
-
-                        // Move negatives values in the range [ct_t::min_goal_speed,
-                        // ct_t::2*max_goal_speed+1]
-                        if (speed_ticks[j] < 0) {
-                            speed_ticks[j] = -speed_ticks[j] + ct_t::max_goal_speed + 1;
-                        }
-                    }
-                    // The actuator is operated as a joint (not continuous rotation)
-                    else if (operating_mode == OperatingMode::joint) {
-                        if (!(speed_ticks[j] >= ct_t::min_goal_speed && speed_ticks[j] <= ct_t::max_goal_speed)) {
-                            throw errors::Error("Desired speed is out actuator's bounds");
-                        }
-                    }
-                }
 
-                std::vector<std::vector<uint8_t>> packed(speed_ticks.size());
-                for (size_t i = 0; i < speed_ticks.size(); i++)
-                    packed[i] = protocol_t::pack_data((typename ct_t::moving_speed_t)speed_ticks[i]);
+                std::vector<typename protocol_t::id_t> typed_ids = _get_typed<typename protocol_t::id_t>(ids);
+                std::vector<double> rad_per_s = _get_typed<double>(speeds);
+                sync_write_builder_t builder;
+                set_moving_speeds_angle(builder, typed_ids.data(), rad_per_s.data(), ids.size(), operating_mode);
+                return builder;
+            }
+
+            /** Build, in a reusable sync write packet, the desired speeds (in
+                radians per second) of several actuators of this model.
 
-                return sync_write_t(ct_t::moving_speed, _get_typed<typename protocol_t::id_t>(ids), packed);
+                @see ProtocolSpecificPackets::set_moving_speeds_angle
+            **/
+            static inline sync_write_builder_t& set_moving_speeds_angle(sync_write_builder_t& builder,
+                const typename protocol_t::id_t* ids, const double* rad_per_s, size_t count, OperatingMode operating_mode)
+            {
+                return ProtocolSpecificPackets<Model, protocol_t>::set_moving_speeds_angle(builder, ids, rad_per_s, count, operating_mode);
             }
 
             // Bulk operations. Only works for MX models with protocol 1. Only works if the models are known and they are all the same
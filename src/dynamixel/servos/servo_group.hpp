@@ -0,0 +1,321 @@
+#ifndef DYNAMIXEL_SERVOS_SERVO_GROUP_HPP_
+#define DYNAMIXEL_SERVOS_SERVO_GROUP_HPP_
+
+#include <stdint.h>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "../batch.hpp"
+#include "../instruction_packet.hpp"
+#include "../instructions/sync_write_builder.hpp"
+#include "../joint_states.hpp"
+#include "../protocols/decode_report.hpp"
+#include "../read_result.hpp"
+#include "../status_packet.hpp"
+#include "position_conversion.hpp"
+#include "servo.hpp"
+
+namespace dynamixel {
+    namespace servos {
+        /// Whether the control table CT has a present_load field
+        template <typename CT>
+        class HasPresentLoad {
+            template <typename C>
+            static char _test(typename C::present_load_t*);
+            template <typename C>
+            static long _test(...);
+
+        public:
+            static const bool value = sizeof(_test<CT>(0)) == 1;
+        };
+
+        /** Location and decoding of the present_load field, for the models
+            that have one; the other models report NaN.
+        **/
+        template <typename CT, bool = HasPresentLoad<CT>::value>
+        struct PresentLoad {
+            static constexpr size_t address(size_t fallback) { return fallback; }
+            static constexpr size_t size() { return 0; }
+
+            template <typename Protocol>
+            static double decode(const uint8_t*, size_t, size_t)
+            {
+                return std::numeric_limits<double>::quiet_NaN();
+            }
+        };
+
+        template <typename CT>
+        struct PresentLoad<CT, true> {
+            static constexpr size_t address(size_t) { return CT::present_load; }
+            static constexpr size_t size() { return sizeof(typename CT::present_load_t); }
+
+            template <typename Protocol>
+            static double decode(const uint8_t* data, size_t size, size_t offset)
+            {
+                typename CT::present_load_t load;
+                Protocol::unpack_data(data, size, offset, load);
+                return load;
+            }
+        };
+
+        /** Fixed set of N actuators of the same model.
+
+            Contrary to a collection of BaseServo pointers, the ids are stored
+            contiguously and all the operations call the static functions of
+            the model: there is no virtual call, no reference counting and no
+            allocation in the control loop.
+
+                std::array<Protocol1::id_t, 4> ids = {{1, 2, 3, 4}};
+                ServoGroup<Mx28, 4> legs(ids);
+                std::array<double, 4> angles;
+                legs.read_positions(controller, angles);
+                controller.send(legs.set_goal_positions(targets));
+        **/
+        template <class Model, size_t N>
+        class ServoGroup {
+        public:
+            typedef typename Servo<Model>::protocol_t protocol_t;
+            typedef typename Servo<Model>::ct_t ct_t;
+            typedef typename protocol_t::id_t id_t;
+            typedef typename std::array<id_t, N>::const_iterator const_iterator;
+
+            static_assert(N > 0, "ServoGroup: a group has at least one actuator");
+
+            explicit ServoGroup(const std::array<id_t, N>& ids)
+                : _ids(ids),
+                  _id_list(ids.begin(), ids.end()),
+                  _states_read(BatchReadInstructions<protocol_t>::packet(_id_list,
+                      std::vector<Field<protocol_t>>(N, Field<protocol_t>(_state_begin(), _state_end() - _state_begin()))))
+            {
+                for (size_t i = 0; i < N; ++i) {
+                    _position_reads[i] = Model::constexpr_get_present_position(ids[i]);
+                    _state_reads[i] = Servo<Model>::static_packets_t::read(ids[i], _state_begin(), _state_end() - _state_begin());
+                }
+            }
+
+            static constexpr size_t size() { return N; }
+
+            id_t id(size_t i) const { return _ids[i]; }
+
+            const std::array<id_t, N>& ids() const { return _ids; }
+
+            const_iterator begin() const { return _ids.begin(); }
+
+            const_iterator end() const { return _ids.end(); }
+
+            /** Build the sync write setting the goal position of all the
+                actuators.
+
+                The packet is built in a buffer owned by the group, and is
+                overwritten by the next call.
+
+                @param rad goal angles, in radians, in the order of the ids
+                @return the packet, to be sent on the serial line
+            **/
+            const InstructionPacket<protocol_t>& set_goal_positions(const std::array<double, N>& rad)
+            {
+                return Servo<Model>::set_goal_positions(_goal_positions, _ids.data(), rad.data(), N);
+            }
+
+            /** Build the sync write setting the speed of all the actuators.
+
+                The packet is built in a buffer owned by the group, and is
+                overwritten by the next call.
+
+                @param rad_per_s desired speeds, in radians per second, in the
+                    order of the ids
+                @param operating_mode (enum) mode in which all the actuators are
+                    controlled; for version 1 of the protocol, it changes how
+                    the negative speeds are encoded
+                @return the packet, to be sent on the serial line
+                @throws errors::ServoLimitError if a speed is out of bounds
+            **/
+            const InstructionPacket<protocol_t>& set_moving_speeds(const std::array<double, N>& rad_per_s,
+                OperatingMode operating_mode = OperatingMode::joint)
+            {
+                return Servo<Model>::set_moving_speeds_angle(_moving_speeds, _ids.data(), rad_per_s.data(), N, operating_mode);
+            }
+
+            /** Convert the goal angles of all the actuators to positions (in the
+                units of the control table).
+
+                @param rad goal angles, in radians
+                @param ticks positions (output)
+                @param violations whether each angle was out of the limits of
+                    the model, and was clamped (output)
+                @return number of angles out of the limits
+            **/
+            static size_t angles_to_ticks(const std::array<double, N>& rad,
+                std::array<typename ct_t::goal_position_t, N>& ticks, std::array<bool, N>& violations)
+            {
+                return PositionConversion<Model>::to_ticks(rad.data(), ticks.data(), violations.data(), N);
+            }
+
+            /** Convert the present positions of all the actuators to angles.
+
+                @param ticks positions, as read from the actuators
+                @param rad angles, in radians (output)
+            **/
+            static void ticks_to_angles(const std::array<typename ct_t::present_position_t, N>& ticks,
+                std::array<double, N>& rad)
+            {
+                PositionConversion<Model>::to_angles(ticks.data(), rad.data(), N);
+            }
+
+            /** Read the current position of all the actuators, one after the
+                other.
+
+                The read packets are computed once, when the group is created.
+                Errors that are specific to one actuator do not interrupt the
+                reads; they are reported in the returned statuses.
+
+                @param controller object handling the USB to dynamixel interface
+                @param rad current angles, in radians, in the order of the ids;
+                    only set for the actuators whose status is ok or servo_error
+                @return status of each read
+            **/
+            template <typename Controller>
+            std::array<ReadStatus, N> read_positions(const Controller& controller, std::array<double, N>& rad) const
+            {
+                std::array<ReadStatus, N> statuses;
+                StatusPacket<protocol_t> status;
+                protocols::DecodeReport report;
+
+                for (size_t i = 0; i < N; ++i) {
+                    controller.send(_position_reads[i]);
+                    statuses[i] = ReadStatus::timeout;
+                    if (!controller.recv(status, report)) {
+                        if (report.error == protocols::DecodeError::checksum)
+                            statuses[i] = ReadStatus::checksum_error;
+                        continue;
+                    }
+                    if (status.id() != _ids[i])
+                        continue;
+                    if (status.parameters().size() != sizeof(typename ct_t::present_position_t)) {
+                        statuses[i] = ReadStatus::size_mismatch;
+                        continue;
+                    }
+                    typename ct_t::present_position_t position;
+                    protocol_t::unpack_data(status.parameters().data(), status.parameters().size(), 0, position);
+                    rad[i] = PositionConversion<Model>::to_angle(position);
+                    statuses[i] = (0 == status.error_byte()) ? ReadStatus::ok : ReadStatus::servo_error;
+                }
+
+                return statuses;
+            }
+
+            /** Read the position, velocity, load and temperature of all the
+                actuators, straight into a joint state buffer.
+
+                These fields are covered by a single range of the control table,
+                read for all the actuators with one sync read (protocol 2) or
+                bulk read (protocol 1), computed once when the group is created.
+                The models that do not understand these instructions (see
+                Servo::bulk_read_support) are read with one Read instruction
+                per actuator. The replies are decoded in place, and errors that
+                are specific to one actuator are reported in the statuses of
+                the buffer.
+
+                @param controller object handling the USB to dynamixel interface
+                @param states buffer receiving the values; actuator i of the
+                    group goes in slot first_slot + i
+                @param first_slot slot of the first actuator of the group
+            **/
+            template <typename Controller>
+            void read_states(const Controller& controller, JointStates& states, size_t first_slot = 0) const
+            {
+                assert(first_slot + N <= states.size());
+
+                if (Model::bulk_read_support()) {
+                    controller.send(_states_read);
+                    recv_replies<protocol_t>(controller, _id_list,
+                        [this, &states, first_slot](size_t i, const StatusPacket<protocol_t>& status) {
+                            states.statuses()[first_slot + i] = _decode_state(status, states, first_slot + i);
+                        },
+                        [&states, first_slot](size_t i, ReadStatus read_status) {
+                            states.statuses()[first_slot + i] = read_status;
+                        });
+                    return;
+                }
+
+                StatusPacket<protocol_t> status;
+                protocols::DecodeReport report;
+                for (size_t i = 0; i < N; ++i)
+                    states.statuses()[first_slot + i] = _read_state(controller, i, states, first_slot + i, status, report);
+            }
+
+        protected:
+            // read the state of actuator i of the group into slot, and give the status of the read
+            template <typename Controller>
+            ReadStatus _read_state(const Controller& controller, size_t i, JointStates& states, size_t slot,
+                StatusPacket<protocol_t>& status, protocols::DecodeReport& report) const
+            {
+                controller.send(_state_reads[i]);
+                if (!controller.recv(status, report))
+                    return (report.error == protocols::DecodeError::checksum) ? ReadStatus::checksum_error : ReadStatus::timeout;
+                if (status.id() != _ids[i])
+                    return ReadStatus::timeout;
+                return _decode_state(status, states, slot);
+            }
+
+            // decode the reply of one actuator into slot, and give the status of the read
+            static ReadStatus _decode_state(const StatusPacket<protocol_t>& status, JointStates& states, size_t slot)
+            {
+                const size_t length = _state_end() - _state_begin();
+                const std::vector<uint8_t>& data = status.parameters();
+                if (data.size() != length)
+                    return ReadStatus::size_mismatch;
+
+                typename ct_t::present_position_t position;
+                typename ct_t::present_speed_t speed;
+                typename ct_t::present_temperature_t temperature;
+                protocol_t::unpack_data(data.data(), length, ct_t::present_position - _state_begin(), position);
+                protocol_t::unpack_data(data.data(), length, ct_t::present_speed - _state_begin(), speed);
+                protocol_t::unpack_data(data.data(), length, ct_t::present_temperature - _state_begin(), temperature);
+
+                states.positions()[slot] = PositionConversion<Model>::to_angle(position);
+                states.velocities()[slot] = Model::present_speed_to_si(speed);
+                states.loads()[slot] = PresentLoad<ct_t>::template decode<protocol_t>(
+                    data.data(), length, PresentLoad<ct_t>::address(0) - _state_begin());
+                states.temperatures()[slot] = temperature;
+                states.timestamps()[slot] = JointStates::now();
+                return (0 == status.error_byte()) ? ReadStatus::ok : ReadStatus::servo_error;
+            }
+
+            static constexpr size_t _min(size_t a, size_t b) { return a < b ? a : b; }
+            static constexpr size_t _max(size_t a, size_t b) { return a > b ? a : b; }
+
+            // first address read by read_states
+            static constexpr size_t _state_begin()
+            {
+                return _min(_min(ct_t::present_position, ct_t::present_speed),
+                    _min(ct_t::present_temperature, PresentLoad<ct_t>::address(ct_t::present_position)));
+            }
+
+            // address following the last byte read by read_states
+            static constexpr size_t _state_end()
+            {
+                return _max(_max(ct_t::present_position + sizeof(typename ct_t::present_position_t),
+                                ct_t::present_speed + sizeof(typename ct_t::present_speed_t)),
+                    _max(ct_t::present_temperature + sizeof(typename ct_t::present_temperature_t),
+                        PresentLoad<ct_t>::address(ct_t::present_position) + PresentLoad<ct_t>::size()));
+            }
+
+            std::array<id_t, N> _ids;
+            // the ids again, as expected by recv_replies
+            std::vector<id_t> _id_list;
+            // sync or bulk read of the states of all the actuators (only sent
+            // to the models that understand it)
+            InstructionPacket<protocol_t> _states_read;
+            std::array<typename Servo<Model>::static_packets_t::read_t, N> _position_reads;
+            std::array<typename Servo<Model>::static_packets_t::read_t, N> _state_reads;
+            instructions::SyncWriteBuilder<protocol_t> _goal_positions;
+            instructions::SyncWriteBuilder<protocol_t> _moving_speeds;
+        };
+    } // namespace servos
+} // namespace dynamixel
+
+#endif
@@ -0,0 +1,303 @@
+#ifndef DYNAMIXEL_SHADOW_TABLE_HPP_
+#define DYNAMIXEL_SHADOW_TABLE_HPP_
+
+#include <stdint.h>
+#include <cstddef>
+#include <map>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "errors/error.hpp"
+#include "errors/status_error.hpp"
+#include "instruction_packet.hpp"
+#include "instructions/sync_write_builder.hpp"
+#include "instructions/write.hpp"
+#include "read_plan.hpp"
+#include "read_result.hpp"
+#include "send_queue.hpp"
+#include "status_packet.hpp"
+
+namespace dynamixel {
+    /** Copy, on the host, of the values written in the control table of
+        several actuators, so that only the values that changed are sent.
+
+        Writing a field only updates the shadow copy and, if the value differs
+        from the last one written, marks its bytes as dirty. `flush` then
+        builds as few packets as possible for the dirty bytes:
+            - the adjacent dirty bytes of an actuator are merged into a single
+              range,
+            - when several actuators have the same dirty range, they are
+              written with a single sync write; otherwise, each range is written
+              with one write instruction.
+
+            ShadowTable<Protocol1> table(ids);
+            for (size_t i = 0; i < ids.size(); ++i) {
+                table.set(i, Mx28::field_goal_position(), goal[i]);
+                table.set(i, Mx28::field_torque_enable(), (uint8_t)1);
+            }
+            table.flush(controller); // nothing is sent for unchanged values
+
+        The values the actuators hold before the first write are unknown, so
+        the first write of each field is always sent. `invalidate` brings the
+        table back to this state (for instance after a reboot).
+    **/
+    template <class Protocol>
+    class ShadowTable {
+    public:
+        typedef typename Protocol::id_t id_t;
+        typedef typename Protocol::address_t address_t;
+
+        explicit ShadowTable(const std::vector<id_t>& ids)
+            : _ids(ids), _values(ids.size()), _states(ids.size()) {}
+
+        const std::vector<id_t>& ids() const { return _ids; }
+
+        /** Write a value in the shadow table.
+
+            @param servo index of the actuator, in the ids given at construction
+            @param address address of the field
+            @param value new value, encoded on sizeof(T) bytes
+            @return whether the value changed (and will be sent by `flush`)
+        **/
+        template <typename T>
+        bool set(size_t servo, address_t address, T value)
+        {
+            uint8_t data[sizeof(T)];
+            Protocol::pack_data(value, data);
+
+            _reserve(address + sizeof(T));
+            std::vector<uint8_t>& values = _values.at(servo);
+            std::vector<uint8_t>& states = _states[servo];
+
+            bool changed = false;
+            for (size_t i = 0; i < sizeof(T); ++i)
+                changed = changed || states[address + i] == _unknown || values[address + i] != data[i];
+
+            // the whole field is sent, even if only some of its bytes changed
+            if (changed) {
+                for (size_t i = 0; i < sizeof(T); ++i) {
+                    values[address + i] = data[i];
+                    states[address + i] = _dirty;
+                }
+            }
+
+            return changed;
+        }
+
+        /// @see set(size_t, address_t, T); sizeof(T) must match the field's size
+        template <typename T>
+        bool set(size_t servo, const Field<Protocol>& field, T value)
+        {
+            if (sizeof(T) != field.size)
+                throw errors::Error("ShadowTable: the value does not have the size of the field");
+            return set(servo, field.address, value);
+        }
+
+        /** Last value written in a field (either flushed or not).
+
+            @throws errors::Error if nothing was written in this field
+        **/
+        template <typename T>
+        T get(size_t servo, address_t address) const
+        {
+            const std::vector<uint8_t>& states = _states.at(servo);
+            for (size_t i = 0; i < sizeof(T); ++i)
+                if (address + i >= states.size() || states[address + i] == _unknown)
+                    throw errors::Error("ShadowTable: unknown value");
+
+            T value;
+            Protocol::unpack_data(_values[servo].data(), _values[servo].size(), address, value);
+            return value;
+        }
+
+        /// Whether some values were not sent yet
+        bool dirty() const
+        {
+            for (size_t s = 0; s < _states.size(); ++s)
+                for (size_t a = 0; a < _states[s].size(); ++a)
+                    if (_states[s][a] == _dirty)
+                        return true;
+            return false;
+        }
+
+        /// Forget the values, so that all the fields are sent on their next write
+        void invalidate()
+        {
+            for (size_t s = 0; s < _states.size(); ++s)
+                _states[s].assign(_states[s].size(), _unknown);
+        }
+
+        /** Build the packets for all the dirty values, and mark them as sent.
+
+            @return sync write packets first (no reply is expected), and then
+                write packets (one reply each, depending on the status return
+                level of the actuators)
+        **/
+        std::vector<InstructionPacket<Protocol>> flush()
+        {
+            std::vector<InstructionPacket<Protocol>> packets;
+            std::vector<id_t> write_ids;
+            _flush(packets, write_ids);
+            return packets;
+        }
+
+        /** Send all the dirty values.
+
+            The sync writes, and the first write, are sent at once (see
+            SendQueue); when the replies are awaited, the other writes are sent
+            one after the other, since each one triggers a reply.
+
+            @param controller object handling the USB to dynamixel interface
+            @param wait_replies whether to wait for the status packet that
+                follows each (non broadcast) write; set it to false if the
+                actuators only reply to read instructions
+            @return number of packets sent
+            @throws errors::StatusError if an actuator reported an error in the
+                reply to its write, or errors::Error if it did not reply (once
+                all the packets are sent; the values are considered as sent,
+                see invalidate)
+        **/
+        template <typename Controller>
+        size_t flush(const Controller& controller, bool wait_replies = true)
+        {
+            std::vector<id_t> write_ids;
+            std::vector<StatusPacket<Protocol>> replies;
+            std::vector<ReadStatus> statuses;
+            size_t sent = _send(controller, wait_replies, write_ids, replies, statuses);
+
+            for (size_t i = 0; i < statuses.size(); ++i) {
+                if (ReadStatus::servo_error == statuses[i])
+                    throw errors::StatusError(write_ids[i], Protocol::version, replies[i].error_byte(),
+                        replies[i].error_message());
+                if (ReadStatus::ok != statuses[i]) {
+                    std::stringstream message;
+                    message << "ShadowTable: the actuator " << (int)write_ids[i]
+                            << " did not reply to a write (" << status2str(statuses[i]) << ")";
+                    throw errors::Error(message.str());
+                }
+            }
+
+            return sent;
+        }
+
+        /** Send all the dirty values, waiting for the reply to each (non
+            broadcast) write, and give the outcome of these writes instead of
+            throwing.
+
+            @param controller object handling the USB to dynamixel interface
+            @param write_ids actuator of each write (output)
+            @param statuses status of the reply to each write (output)
+            @return number of packets sent
+        **/
+        template <typename Controller>
+        size_t flush(const Controller& controller, std::vector<id_t>& write_ids, std::vector<ReadStatus>& statuses)
+        {
+            std::vector<StatusPacket<Protocol>> replies;
+            return _send(controller, true, write_ids, replies, statuses);
+        }
+
+    protected:
+        // state of each byte of the shadow table
+        enum {
+            _unknown = 0,
+            _clean,
+            _dirty
+        };
+
+        // send the dirty values, and receive the replies to the writes if
+        // wait_replies is set (write_ids, replies and statuses stay empty
+        // otherwise)
+        template <typename Controller>
+        size_t _send(const Controller& controller, bool wait_replies, std::vector<id_t>& write_ids,
+            std::vector<StatusPacket<Protocol>>& replies, std::vector<ReadStatus>& statuses)
+        {
+            std::vector<InstructionPacket<Protocol>> packets;
+            std::vector<id_t> ids;
+            size_t n_sync_writes = _flush(packets, ids);
+            SendQueue<Protocol> queue;
+            std::vector<StatusPacket<Protocol>> reply;
+            std::vector<ReadStatus> status;
+
+            write_ids.clear();
+            replies.clear();
+            statuses.clear();
+            for (size_t i = 0; i < packets.size(); ++i) {
+                if (!wait_replies || i < n_sync_writes) {
+                    queue.push(packets[i]);
+                    continue;
+                }
+                queue.push(packets[i], ids[i - n_sync_writes]);
+                queue.exchange(controller, reply, status);
+                write_ids.push_back(ids[i - n_sync_writes]);
+                replies.push_back(reply[0]);
+                statuses.push_back(status[0]);
+            }
+            queue.flush(controller);
+
+            return packets.size();
+        }
+
+        // build the packets (sync writes first), give the actuator of each
+        // write, and return the number of sync writes
+        size_t _flush(std::vector<InstructionPacket<Protocol>>& packets, std::vector<id_t>& write_ids)
+        {
+            // actuators, for each dirty range [begin, end)
+            typedef std::pair<size_t, size_t> range_t;
+            std::map<range_t, std::vector<size_t>> ranges;
+
+            for (size_t s = 0; s < _states.size(); ++s) {
+                std::vector<uint8_t>& states = _states[s];
+                for (size_t a = 0; a < states.size(); ++a) {
+                    if (states[a] != _dirty)
+                        continue;
+                    size_t end = a;
+                    while (end < states.size() && states[end] == _dirty)
+                        states[end++] = _clean;
+                    ranges[range_t(a, end)].push_back(s);
+                    a = end;
+                }
+            }
+
+            std::vector<InstructionPacket<Protocol>> writes;
+            for (typename std::map<range_t, std::vector<size_t>>::const_iterator it = ranges.begin(); it != ranges.end(); ++it) {
+                size_t begin = it->first.first, length = it->first.second - it->first.first;
+                const std::vector<size_t>& servos = it->second;
+
+                if (servos.size() > 1) {
+                    instructions::SyncWriteBuilder<Protocol> builder;
+                    builder.start(begin, length, servos.size());
+                    for (size_t i = 0; i < servos.size(); ++i)
+                        builder.set_raw(i, _ids[servos[i]], &_values[servos[i]][begin]);
+                    packets.push_back(builder.finalize());
+                }
+                else {
+                    std::vector<uint8_t> data(_values[servos[0]].begin() + begin,
+                        _values[servos[0]].begin() + begin + length);
+                    writes.push_back(instructions::Write<Protocol>(_ids[servos[0]], begin, data));
+                    write_ids.push_back(_ids[servos[0]]);
+                }
+            }
+
+            size_t n_sync_writes = packets.size();
+            packets.insert(packets.end(), writes.begin(), writes.end());
+            return n_sync_writes;
+        }
+
+        void _reserve(size_t size)
+        {
+            if (_values.empty() || _values[0].size() >= size)
+                return;
+            for (size_t s = 0; s < _values.size(); ++s) {
+                _values[s].resize(size, 0);
+                _states[s].resize(size, _unknown);
+            }
+        }
+
+        std::vector<id_t> _ids;
+        std::vector<std::vector<uint8_t>> _values;
+        std::vector<std::vector<uint8_t>> _states;
+    };
+} // namespace dynamixel
+
+#endif
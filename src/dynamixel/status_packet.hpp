@@ -5,8 +5,10 @@
 #include <stdint.h>
 #include <cassert>
 #include <iostream>
+#include <string>
 
 #include "./errors/error.hpp"
+#include "./protocols/decode_report.hpp"
 
 namespace dynamixel {
     template <class Protocol>
@@ -14,7 +16,7 @@ namespace dynamixel {
     public:
         using DecodeState = typename Protocol::DecodeState;
 
-        StatusPacket() : _valid(false) {}
+        StatusPacket() : _valid(false), _error_byte(0) {}
 
         bool valid() const { return _valid; }
 
@@ -32,12 +34,64 @@ namespace dynamixel {
             return _parameters;
         }
 
+        /** Raw error field of the last decoded packet.
+
+            It can only be non-zero if the packet was decoded with the
+            non-throwing version of decode_packet.
+        **/
+        uint8_t error_byte() const
+        {
+            if (!_valid)
+                throw errors::Error("StatusPacket: should be valid before calling member function: `error_byte`");
+            return _error_byte;
+        }
+
+        /** Explanation of the error reported by the actuator, if any.
+
+            The message is only formatted when this method is called.
+        **/
+        std::string error_message() const
+        {
+            if (!_valid)
+                throw errors::Error("StatusPacket: should be valid before calling member function: `error_message`");
+            if (0 == _error_byte)
+                return "";
+            return Protocol::status_error_message(_id, _error_byte);
+        }
+
         DecodeState decode_packet(const std::vector<uint8_t>& packet, bool report_bad_packet = false)
         {
             DecodeState state = Protocol::unpack_status(packet, _id, _parameters, report_bad_packet);
 
-            if (state == DecodeState::DONE)
+            if (state == DecodeState::DONE) {
+                _valid = true;
+                _error_byte = 0;
+            }
+
+            return state;
+        }
+
+        /** Non-throwing version of decode_packet.
+
+            A packet in which the actuator reported an error is still accepted
+            (the state is DONE); report.error is then set to
+            DecodeError::servo_error and the error field can be retrieved with
+            error_byte.
+
+            @param packet content of the received packet
+            @param report details on why the packet is invalid or on the error
+                reported by the actuator
+
+            @return the state of the packet unpacking
+        **/
+        DecodeState decode_packet(const std::vector<uint8_t>& packet, protocols::DecodeReport& report)
+        {
+            DecodeState state = Protocol::decode_status(packet, _id, _parameters, report);
+
+            if (state == DecodeState::DONE) {
                 _valid = true;
+                _error_byte = report.error_byte;
+            }
 
             return state;
         }
@@ -62,6 +116,7 @@ namespace dynamixel {
         bool _valid;
         typename Protocol::id_t _id;
         std::vector<uint8_t> _parameters;
+        uint8_t _error_byte;
     };
 
     template <typename Protocol>
@@ -1,19 +1,102 @@
+#include <iomanip>
+#include <sstream>
 #include <vector>
 #include <sys/types.h>
 
 #include "../dynamixel/controllers/file2dynamixel.hpp"
+#include "../dynamixel/instructions/prepared_sync_write.hpp"
+#include "../dynamixel/instructions/sync_write.hpp"
+#include "../dynamixel/instructions/sync_write_builder.hpp"
+#include "../dynamixel/async_bus.hpp"
+#include "../dynamixel/batch.hpp"
+#ifdef __cpp_impl_coroutine
+#include "../dynamixel/coroutines.hpp"
+#endif
+#include "../dynamixel/benchmark.hpp"
+#include "../dynamixel/bus_manager.hpp"
+#include "../dynamixel/eeprom_cache.hpp"
+#include "../dynamixel/indirect_mapping.hpp"
+#include "../dynamixel/monitor.hpp"
+#include "../dynamixel/read_result.hpp"
+#include "../dynamixel/send_queue.hpp"
+#include "../dynamixel/servos.hpp"
+#include "../dynamixel/operating_mode.hpp"
+#include "../dynamixel/pipeline.hpp"
+#include "../dynamixel/shadow_table.hpp"
 
 using namespace dynamixel;
 using namespace protocols;
 using namespace controllers;
 
+std::vector<uint8_t> status_reply_2(uint8_t id, const std::vector<uint8_t>& parameters);
+
 void test_unpack_status_1();
 void test_unpack_status_2();
+void test_decode_status_2();
+void test_recv_results_2();
+void test_unpack_offset_2();
+template <typename Protocol>
+void test_sync_write_builder();
+template <typename Protocol>
+void test_prepared_sync_write();
+void test_static_packets();
+void test_read_plan_1();
+void test_indirect_mapping_2();
+void test_servo_group_1();
+void test_joint_states_1();
+void test_joint_states_2();
+void test_read_positions_1();
+void test_position_conversion();
+void test_moving_speeds_1();
+void test_shadow_table_1();
+void test_eeprom_cache_1();
+void test_operating_modes();
+void test_batch_1();
+void test_batch_write_2();
+void test_monitor_1();
+void test_benchmark_1();
+void test_bus_manager_1();
+void test_send_queue_1();
+void test_pipeline_1();
+void test_async_bus_1();
+#ifdef __cpp_impl_coroutine
+void test_coroutines_1();
+#endif
 
 int main()
 {
     // test_unpack_status_1();
     test_unpack_status_2();
+    test_decode_status_2();
+    test_recv_results_2();
+    test_unpack_offset_2();
+    test_sync_write_builder<Protocol1>();
+    test_sync_write_builder<Protocol2>();
+    test_prepared_sync_write<Protocol1>();
+    test_prepared_sync_write<Protocol2>();
+    test_static_packets();
+    test_read_plan_1();
+    test_indirect_mapping_2();
+    test_servo_group_1();
+    test_joint_states_1();
+    test_joint_states_2();
+    test_read_positions_1();
+    test_position_conversion();
+    test_moving_speeds_1();
+    test_shadow_table_1();
+    test_eeprom_cache_1();
+    test_operating_modes();
+    test_batch_1();
+    test_batch_write_2();
+    test_monitor_1();
+    test_benchmark_1();
+    test_bus_manager_1();
+    test_send_queue_1();
+    test_pipeline_1();
+    test_async_bus_1();
+#ifdef __cpp_impl_coroutine
+    test_coroutines_1();
+#endif
     return 0;
 }
 
@@ -126,4 +209,893 @@ void test_unpack_status_2()
     catch (dynamixel::errors::Error e) {
         std::cout << "Catched exception\n\t" << e << std::endl;
     }
-}
\ No newline at end of file
+}
+void test_decode_status_2()
+{
+    std::cout << "Non-throwing decoding of status packets (protocol 2)" << std::endl;
+
+    // An error is reported by actuator 4 (harware error and result fail)
+    std::vector<uint8_t> packet = {0xFF, 0xFF, 0xFD, 0x00, 0x04, 0x08, 0x00, 0x55, 0x84, 0xA6, 0x00, 0x00, 0x00, 0x8C, 0xE2};
+
+    StatusPacket<Protocol2> status;
+    protocols::DecodeReport report;
+    Protocol2::DecodeState state = status.decode_packet(packet, report);
+
+    std::cout << "\tstate " << (state == Protocol2::DONE ? "DONE" : "not done")
+              << ", error byte 0x" << std::hex << (int)report.error_byte << std::dec
+              << ", " << status << std::endl;
+    std::cout << "\t" << status.error_message() << std::endl;
+
+    // same packet, with a wrong checksum
+    packet.back() = 0x00;
+    state = status.decode_packet(packet, report);
+    std::cout << "\tstate " << (state == Protocol2::INVALID ? "INVALID" : "not invalid")
+              << ", checksum error: "
+              << (report.error == protocols::DecodeError::checksum ? "yes" : "no")
+              << std::endl;
+
+    // unpacking data with the wrong size
+    uint16_t value;
+    std::vector<uint8_t> data = {0x01, 0x02, 0x03};
+    std::cout << "\tunpacking 3 bytes in 16 bits: "
+              << (Protocol2::unpack_data(data, value, std::nothrow) ? "accepted" : "rejected")
+              << std::endl;
+}
+
+void test_recv_results_2()
+{
+    std::cout << "Per-actuator results of a batched read (protocol 2)" << std::endl;
+
+    int flags = (O_WRONLY | O_CREAT | O_TRUNC);
+    File2Dynamixel interface("frames.dat", flags);
+
+    // Reply from actuator 1, with 3 bytes of data
+    std::vector<uint8_t> packet = {0xFF, 0xFF, 0xFD, 0x00, 0x01, 0x07, 0x00, 0x55, 0x00, 0x06, 0x04, 0x26, 0x65, 0x5D};
+    interface.send(packet);
+
+    // Actuator 4 replies with an error (harware error and result fail)
+    packet = {0xFF, 0xFF, 0xFD, 0x00, 0x04, 0x08, 0x00, 0x55, 0x84, 0xA6, 0x00, 0x00, 0x00, 0x8C, 0xE2};
+    interface.send(packet);
+
+    // Actuator 5 replies with a wrong checksum
+    packet = {0xFF, 0xFF, 0xFD, 0x00, 0x05, 0x08, 0x00, 0x55, 0x00, 0xA6, 0x00, 0x00, 0x00, 0x00, 0x00};
+    interface.send(packet);
+
+    // Actuator 6 replies with 4 bytes of data
+    interface.send(status_reply_2(6, {0x2A, 0x00, 0x00, 0x00}));
+
+    // Actuator 7 replies with a wrong checksum, and is the last one to reply
+    packet = {0xFF, 0xFF, 0xFD, 0x00, 0x07, 0x08, 0x00, 0x55, 0x00, 0xA6, 0x00, 0x00, 0x00, 0x00, 0x00};
+    interface.send(packet);
+
+    interface.close_file();
+    interface.open_file("frames.dat", O_RDONLY);
+
+    std::vector<Protocol2::id_t> ids = {1, 4, 5, 6, 7, 8};
+    std::vector<ReadResult<Protocol2, uint32_t>> results
+        = recv_results<uint32_t, Protocol2>(interface, ids);
+
+    for (auto result : results) {
+        std::cout << "\tid " << (int)result.id << ": " << status2str(result.status);
+        if (result.has_value())
+            std::cout << ", value " << std::dec << result.value;
+        std::cout << std::endl;
+    }
+}
+
+void test_unpack_offset_2()
+{
+    std::cout << "Decoding several fields from one read (protocol 2)" << std::endl;
+
+    // goal position (int32), moving speed (uint32) and torque limit (int16)
+    uint8_t buffer[10];
+    size_t size = 0;
+    size += Protocol2::pack_data((int32_t)-1024, buffer, size);
+    size += Protocol2::pack_data((uint32_t)300, buffer, size);
+    size += Protocol2::pack_data((int16_t)-2, buffer, size);
+
+    int32_t position;
+    uint32_t speed;
+    int16_t torque;
+    Protocol2::unpack_data(buffer, size, 0, position);
+    Protocol2::unpack_data(buffer, size, 4, speed);
+    Protocol2::unpack_data(buffer, size, 8, torque);
+    std::cout << "\tposition " << std::dec << position << ", speed " << speed
+              << ", torque " << torque << std::endl;
+
+    std::cout << "\tunpacking 32 bits at offset 8 of 10 bytes: "
+              << (Protocol2::unpack_data(buffer, size, 8, speed, std::nothrow) ? "accepted" : "rejected")
+              << std::endl;
+}
+
+template <typename Protocol>
+void test_sync_write_builder()
+{
+    std::cout << "Sync write built in place (protocol " << (int)Protocol::version
+              << ")" << std::endl;
+
+    std::vector<typename Protocol::id_t> ids = {1, 2, 3};
+    uint16_t values[] = {0x0150, 0x0220, 0x03FF};
+    std::vector<std::vector<uint8_t>> data;
+    for (size_t i = 0; i < ids.size(); ++i)
+        data.push_back(Protocol::pack_data(values[i]));
+
+    instructions::SyncWrite<Protocol> reference(30, ids, data);
+    instructions::SyncWriteBuilder<Protocol> builder;
+    // built twice, to check that the buffer is properly reused
+    builder.build(12, &ids.front(), values, 2);
+    builder.build(30, &ids.front(), values, ids.size());
+
+    bool identical = reference.size() == builder.size();
+    for (size_t i = 0; identical && i < builder.size(); ++i)
+        identical = reference[i] == builder[i];
+    std::cout << "\t" << (identical ? "identical" : "different")
+              << " to the SyncWrite instruction" << std::endl;
+}
+
+template <typename Protocol>
+void test_prepared_sync_write()
+{
+    std::cout << "Sync write patched in place (protocol " << (int)Protocol::version
+              << ")" << std::endl;
+
+    std::vector<typename Protocol::id_t> ids = {1, 2, 3, 4};
+    uint16_t values[][4] = {{0x0150, 0x0220, 0x03FF, 0x0000},
+        {0x0150, 0x0221, 0x03FF, 0x0100},
+        {0x0F00, 0x0221, 0x03FF, 0x0100}};
+
+    instructions::PreparedSyncWrite<Protocol> prepared(30, 2, ids);
+    for (size_t step = 0; step < 3; ++step) {
+        for (size_t i = 0; i < ids.size(); ++i)
+            prepared.set(i, values[step][i]);
+        prepared.finalize();
+
+        instructions::SyncWriteBuilder<Protocol> reference;
+        reference.build(30, &ids.front(), values[step], ids.size());
+
+        bool identical = reference.size() == prepared.size();
+        for (size_t i = 0; identical && i < prepared.size(); ++i)
+            identical = reference[i] == prepared[i];
+        std::cout << "\tstep " << step << ": "
+                  << (identical ? "identical" : "different")
+                  << " to a new packet" << std::endl;
+    }
+}
+
+template <typename Array, typename Protocol>
+bool same_packet(const Array& array, const InstructionPacket<Protocol>& packet)
+{
+    if (array.size() != packet.size())
+        return false;
+    for (size_t i = 0; i < packet.size(); ++i)
+        if (array[i] != packet[i])
+            return false;
+    return true;
+}
+
+void test_static_packets()
+{
+    std::cout << "Packets computed at compile time" << std::endl;
+
+    constexpr auto read_1 = servos::Mx28::constexpr_get_present_position(1);
+    constexpr auto read_2 = servos::Mx28P2::constexpr_get_present_position(1);
+    constexpr auto ping_2 = instructions::StaticPackets<Protocol2>::ping(1);
+    constexpr auto action_1 = instructions::StaticPackets<Protocol1>::action();
+
+    std::cout << "\tread (protocol 1): "
+              << (same_packet(read_1, servos::Mx28::get_present_position(1)) ? "identical" : "different")
+              << std::endl;
+    std::cout << "\tread (protocol 2): "
+              << (same_packet(read_2, servos::Mx28P2::get_present_position(1)) ? "identical" : "different")
+              << std::endl;
+    std::cout << "\tping (protocol 2): "
+              << (same_packet(ping_2, instructions::Ping<Protocol2>(1)) ? "identical" : "different")
+              << std::endl;
+    std::cout << "\taction (protocol 1): "
+              << (same_packet(action_1, instructions::Action<Protocol1>(Protocol1::broadcast_id)) ? "identical" : "different")
+              << std::endl;
+}
+
+void test_read_plan_1()
+{
+    std::cout << "Coalesced read of several fields (protocol 1)" << std::endl;
+
+    ReadPlan<Protocol1> plan;
+    size_t load = plan.add(servos::Mx28::field_present_load());
+    size_t position = plan.add(servos::Mx28::field_present_position());
+    size_t goal = plan.add(servos::Mx28::field_goal_position());
+    size_t speed = plan.add(servos::Mx28::field_present_speed());
+
+    const std::vector<ReadRange<Protocol1>>& ranges = plan.ranges();
+    for (size_t i = 0; i < ranges.size(); ++i)
+        std::cout << "\trange " << std::dec << (int)ranges[i].address << ", "
+                  << (int)ranges[i].length << " bytes" << std::endl;
+
+    // replies for the two ranges
+    plan.set_data(0, {0x00, 0x02});
+    plan.set_data(1, {0x10, 0x02, 0x20, 0x00, 0x30, 0x04});
+
+    std::cout << "\tgoal " << plan.get<uint16_t>(goal)
+              << ", position " << plan.get<uint16_t>(position)
+              << ", speed " << plan.get<uint16_t>(speed)
+              << ", load " << plan.get<uint16_t>(load) << std::endl;
+}
+
+void test_indirect_mapping_2()
+{
+    std::cout << "Indirect mapping of scattered fields (protocol 2)" << std::endl;
+
+    IndirectMapping<servos::Mx28P2> mapping;
+    size_t current = mapping.add(servos::Mx28P2::field_present_current());
+    size_t position = mapping.add(servos::Mx28P2::field_present_position());
+    size_t error = mapping.add(servos::Mx28P2::field_hardware_error_status());
+
+    std::vector<uint8_t> entries = mapping.mapping_data();
+    std::cout << "\tindirect addresses:" << std::dec;
+    for (size_t i = 0; i < entries.size(); i += 2)
+        std::cout << " " << (entries[i] | (entries[i + 1] << 8));
+    std::cout << std::endl;
+    std::cout << "\tblock at " << mapping.block().address << ", "
+              << mapping.block().size << " bytes" << std::endl;
+
+    // blocks of two actuators, as filled by a sync read
+    std::vector<uint8_t> data = {0xF6, 0xFF, 0x00, 0x08, 0x00, 0x00, 0x00,
+        0x0A, 0x00, 0x00, 0xF0, 0xFF, 0xFF, 0x04};
+    for (size_t i = 0; i < 2; ++i)
+        std::cout << "\tactuator " << i << ": current " << mapping.get<int16_t>(data, i, current)
+                  << ", position " << mapping.get<int32_t>(data, i, position)
+                  << ", error " << (int)mapping.get<uint8_t>(data, i, error) << std::endl;
+}
+
+void test_servo_group_1()
+{
+    std::cout << "Static group of servos (protocol 1)" << std::endl;
+
+    std::array<Protocol1::id_t, 3> group_ids = {{1, 2, 3}};
+    servos::ServoGroup<servos::Mx28, 3> group(group_ids);
+    std::array<double, 3> angles = {{1.0, 2.0, 3.0}};
+
+    std::vector<Protocol1::id_t> ids(group.begin(), group.end());
+    std::vector<double> positions(angles.begin(), angles.end());
+    InstructionPacket<Protocol1> reference = servos::Mx28::set_goal_positions(ids, positions);
+
+    std::cout << "\tsync write "
+              << (same_packet(reference, group.set_goal_positions(angles)) ? "identical" : "different")
+              << " to Mx28::set_goal_positions" << std::endl;
+}
+
+// Controller replaying prepared status packets, and ignoring what is sent
+struct ReplayController {
+    ReplayController() : next(0), sent(0), timeouts(0) {}
+
+    template <typename Packet>
+    void send(const Packet&) const { ++sent; }
+
+    void send(const uint8_t*, size_t) const { ++sent; }
+
+    template <typename Protocol>
+    bool recv(StatusPacket<Protocol>& status, protocols::DecodeReport& report) const
+    {
+        if (next >= replies.size()) {
+            ++timeouts;
+            return false;
+        }
+        return status.decode_packet(replies[next++], report) == Protocol::DONE;
+    }
+
+    template <typename Protocol>
+    bool recv(StatusPacket<Protocol>& status) const
+    {
+        protocols::DecodeReport report;
+        return recv(status, report);
+    }
+
+    std::vector<std::vector<uint8_t>> replies;
+    mutable size_t next;
+    mutable size_t sent;
+    // receptions that waited for the whole timeout
+    mutable size_t timeouts;
+};
+
+// Status packet of an actuator that has no error to report
+std::vector<uint8_t> status_reply_1(uint8_t id, const std::vector<uint8_t>& parameters)
+{
+    std::vector<uint8_t> packet = {0xFF, 0xFF, id, (uint8_t)(parameters.size() + 2), 0x00};
+    packet.insert(packet.end(), parameters.begin(), parameters.end());
+    uint8_t sum = 0;
+    for (size_t i = 2; i < packet.size(); ++i)
+        sum += packet[i];
+    packet.push_back(~sum);
+    return packet;
+}
+
+std::vector<uint8_t> status_reply_2(uint8_t id, const std::vector<uint8_t>& parameters)
+{
+    size_t length = parameters.size() + 4;
+    std::vector<uint8_t> packet = {0xFF, 0xFF, 0xFD, 0x00, id, (uint8_t)(length & 0xFF), (uint8_t)(length >> 8), 0x55, 0x00};
+    packet.insert(packet.end(), parameters.begin(), parameters.end());
+    uint16_t crc = Protocol2::crc(packet.data(), packet.size());
+    packet.push_back(crc & 0xFF);
+    packet.push_back(crc >> 8);
+    return packet;
+}
+
+void test_joint_states_1()
+{
+    std::cout << "Joint states read by a group (protocol 1)" << std::endl;
+
+    std::array<Protocol1::id_t, 2> group_ids = {{1, 2}};
+    servos::ServoGroup<servos::Mx28, 2> group(group_ids);
+
+    // actuator 1 replies with addresses 36 to 43; actuator 2 does not reply
+    ReplayController controller;
+    controller.replies.push_back({0xFF, 0xFF, 0x01, 0x0A, 0x00, 0x00, 0x08, 0x40, 0x04, 0x20, 0x00, 0x78, 0x2A, 0xE6});
+
+    JointStates states(3);
+    group.read_states(controller, states, 1);
+    for (size_t slot = 0; slot < states.size(); ++slot)
+        std::cout << "\tslot " << slot << ": " << status2str(states.statuses()[slot])
+                  << ", position " << states.positions()[slot]
+                  << ", velocity " << states.velocities()[slot]
+                  << ", load " << states.loads()[slot]
+                  << ", temperature " << states.temperatures()[slot] << std::endl;
+    std::cout << "\t" << controller.sent << " instruction(s) sent, "
+              << controller.timeouts << " timeout(s)" << std::endl;
+
+    // the AX series does not answer bulk reads: one read per actuator
+    servos::ServoGroup<servos::Ax12, 2> ax_group(group_ids);
+    ReplayController ax_controller;
+    ax_controller.replies.push_back(status_reply_1(1, {0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x28}));
+    ax_controller.replies.push_back(status_reply_1(2, {0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x29}));
+    ax_group.read_states(ax_controller, states, 0);
+    std::cout << "\tAX-12: " << status2str(states.statuses()[0]) << " and "
+              << status2str(states.statuses()[1]) << ", "
+              << ax_controller.sent << " instruction(s) sent" << std::endl;
+}
+
+void test_joint_states_2()
+{
+    std::cout << "Joint states read by a group (protocol 2)" << std::endl;
+
+    std::array<Protocol2::id_t, 2> group_ids = {{1, 2}};
+    servos::ServoGroup<servos::Mx28P2, 2> group(group_ids);
+
+    // addresses 128 to 146: speed, position and temperature of each actuator
+    ReplayController controller;
+    for (uint8_t id = 1; id <= 2; ++id) {
+        std::vector<uint8_t> data(19, 0);
+        data[0] = 0x0A; // speed
+        data[4] = 0x00; // position 2048
+        data[5] = 0x08;
+        data[18] = 0x28 + id; // temperature
+        controller.replies.push_back(status_reply_2(id, data));
+    }
+
+    JointStates states(2);
+    group.read_states(controller, states);
+    for (size_t slot = 0; slot < states.size(); ++slot)
+        std::cout << "\tslot " << slot << ": " << status2str(states.statuses()[slot])
+                  << ", position " << states.positions()[slot]
+                  << ", temperature " << states.temperatures()[slot] << std::endl;
+    std::cout << "\t" << controller.sent << " instruction(s) sent" << std::endl;
+}
+
+void test_read_positions_1()
+{
+    std::cout << "Positions read by a group (protocol 1)" << std::endl;
+
+    std::array<Protocol1::id_t, 1> group_ids = {{1}};
+    servos::ServoGroup<servos::Mx28, 1> group(group_ids);
+
+    // position 2049, a fraction of degree above the middle
+    ReplayController controller;
+    controller.replies.push_back(status_reply_1(1, {0x01, 0x08}));
+
+    std::array<double, 1> angles = {{0.}};
+    std::array<ReadStatus, 1> statuses = group.read_positions(controller, angles);
+    std::cout << "	" << status2str(statuses[0]) << ", position " << angles[0]
+              << " (" << servos::PositionConversion<servos::Mx28>::to_angle(2049) << " expected)" << std::endl;
+}
+
+void test_position_conversion()
+{
+    std::cout << "Batch conversion of angles" << std::endl;
+
+    typedef servos::ServoGroup<servos::Mx28, 4> group_t;
+    std::array<double, 4> rad = {{0., 3.14159265, 7., -0.1}};
+    std::array<uint16_t, 4> ticks;
+    std::array<bool, 4> violations;
+    size_t n_violations = group_t::angles_to_ticks(rad, ticks, violations);
+
+    std::cout << "\t" << n_violations << " out of limits:";
+    for (size_t i = 0; i < 4; ++i)
+        std::cout << " " << ticks[i] << (violations[i] ? " (clamped)" : "");
+    std::cout << std::endl;
+
+    std::array<double, 4> back;
+    group_t::ticks_to_angles(ticks, back);
+    std::cout << "\tback to angles:";
+    for (size_t i = 0; i < 4; ++i)
+        std::cout << " " << back[i];
+    std::cout << std::endl;
+}
+
+void test_moving_speeds_1()
+{
+    std::cout << "Batched wheel speeds (protocol 1)" << std::endl;
+
+    std::array<Protocol1::id_t, 2> group_ids = {{1, 2}};
+    servos::ServoGroup<servos::Mx28, 2> group(group_ids);
+    std::array<double, 2> speeds = {{1.0, -1.0}};
+    const InstructionPacket<Protocol1>& packet = group.set_moving_speeds(speeds, OperatingMode::wheel);
+
+    // the value of each actuator, as encoded by the single-actuator packet
+    bool identical = true;
+    for (size_t i = 0; i < 2; ++i) {
+        InstructionPacket<Protocol1> single = servos::Mx28::set_moving_speed_angle(group_ids[i], speeds[i], OperatingMode::wheel);
+        // slot i starts after the header, the address, the length and the id
+        identical = identical && single[6] == packet[8 + 3 * i] && single[7] == packet[9 + 3 * i];
+    }
+    std::cout << "\tvalues " << (identical ? "identical" : "different")
+              << " to set_moving_speed_angle" << std::endl;
+}
+
+void test_shadow_table_1()
+{
+    std::cout << "Shadow control table (protocol 1)" << std::endl;
+
+    std::vector<Protocol1::id_t> ids = {1, 2, 3};
+    ShadowTable<Protocol1> table(ids);
+
+    for (size_t step = 0; step < 3; ++step) {
+        for (size_t i = 0; i < ids.size(); ++i) {
+            table.set(i, servos::Mx28::field_torque_enable(), (uint8_t)1);
+            // only the goal of the last actuator changes after the first step
+            table.set(i, servos::Mx28::field_goal_position(), (uint16_t)(i == 2 ? 100 * step : 512));
+        }
+        // the moving speed follows the goal position (adjacent addresses)
+        if (step == 2)
+            table.set(2, servos::Mx28::field_moving_speed(), (uint16_t)200);
+
+        std::vector<InstructionPacket<Protocol1>> packets = table.flush();
+        std::cout << "\tstep " << step << ": " << packets.size() << " packet(s)";
+        for (size_t i = 0; i < packets.size(); ++i)
+            std::cout << (packets[i][4] == Protocol1::Instructions::sync_write ? " sync_write" : " write")
+                      << "(" << std::dec << (int)packets[i][5] << ", " << packets[i].size() << " bytes)";
+        std::cout << std::endl;
+    }
+
+    // actuator 3 replies to its write with an input voltage error, and then
+    // does not reply anymore
+    ReplayController controller;
+    controller.replies.push_back({0xFF, 0xFF, 0x03, 0x02, 0x01, 0xF9});
+    table.set(2, servos::Mx28::field_goal_position(), (uint16_t)300);
+    std::vector<Protocol1::id_t> write_ids;
+    std::vector<ReadStatus> statuses;
+    table.flush(controller, write_ids, statuses);
+    for (size_t i = 0; i < write_ids.size(); ++i)
+        std::cout << "\twrite to " << (int)write_ids[i] << ": " << status2str(statuses[i]) << std::endl;
+    table.set(2, servos::Mx28::field_goal_position(), (uint16_t)400);
+    try {
+        table.flush(controller);
+    }
+    catch (const errors::Error& e) {
+        std::cout << "\t" << e.msg() << std::endl;
+    }
+}
+
+void test_eeprom_cache_1()
+{
+    std::cout << "EEPROM cache (protocol 1)" << std::endl;
+
+    // EEPROM area of an MX-28 with id 1: model 29, firmware 36, joint mode
+    std::vector<uint8_t> reply = {0xFF, 0xFF, 0x01, 26, 0x00,
+        0x1D, 0x00, 0x24, 0x01, 0x01, 0xFA, 0x00, 0x00, 0xFF, 0x0F, 0x00, 0x50,
+        0x3C, 0x8C, 0xFF, 0x03, 0x02, 0x24, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00};
+    uint8_t sum = 0;
+    for (size_t i = 2; i < reply.size(); ++i)
+        sum += reply[i];
+    reply.push_back(~sum);
+
+    ReplayController controller;
+    controller.replies.push_back(reply);
+
+    EepromCache<Protocol1> cache;
+    std::cout << "	model " << cache.get<uint16_t>(controller, 1, servos::Mx28::field_model_number())
+              << ", firmware " << (int)cache.get<uint8_t>(controller, 1, servos::Mx28::ct_t::firmware_version)
+              << ", mode " << mode2str(operating_mode(controller, 1, cache))
+              << ", " << controller.sent << " packet(s) sent" << std::endl;
+
+    // a write in the RAM area keeps the cache, a write in the EEPROM area does not
+    cache.invalidate(1, servos::Mx28::ct_t::goal_position, 2);
+    std::cout << "	after a RAM write: " << (cache.cached(1) ? "cached" : "not cached") << std::endl;
+    cache.invalidate(1, servos::Mx28::ct_t::cw_angle_limit, 2);
+    std::cout << "	after an EEPROM write: " << (cache.cached(1) ? "cached" : "not cached") << std::endl;
+    try {
+        operating_mode(controller, 1, cache);
+    }
+    catch (const errors::Error& e) {
+        std::cout << "	" << controller.sent << " packet(s) sent, " << e.msg() << std::endl;
+    }
+
+    // the scan fills the cache: the operating mode does not cost any packet
+    ReplayController bus;
+    bus.replies.push_back(status_reply_1(1, {}));
+    bus.replies.push_back(reply);
+    EepromCache<Protocol1> scan_cache;
+    std::vector<Protocol1::id_t> ids = {1};
+    auto found = auto_detect_map<Protocol1>(bus, ids, scan_cache);
+    std::cout << "\tscan: " << found.size() << " " << found[1]->model_name()
+              << ", mode " << mode2str(operating_mode(bus, 1, scan_cache))
+              << ", " << bus.sent << " packet(s) sent" << std::endl;
+
+    std::cout << "\tEEPROM sizes: XL-320 " << servos::Xl320(1).eeprom_size()
+              << ", MX-28 (protocol 2) " << servos::Mx28P2(1).eeprom_size()
+              << ", H54-200-S500 " << servos::ProH54200S500(1).eeprom_size() << std::endl;
+}
+
+void test_operating_modes()
+{
+    std::cout << "Operating mode of several actuators" << std::endl;
+
+    std::vector<Protocol1::id_t> ids = {1, 2, 3};
+    InstructionPacket<Protocol1> bulk_read = instructions::BulkRead<Protocol1>(
+        std::vector<Protocol1::address_t>(ids.size(), 6), ids, std::vector<uint8_t>(ids.size(), 4));
+    std::cout << "\tbulk read:";
+    for (size_t i = 0; i < bulk_read.size(); ++i)
+        std::cout << " " << std::hex << std::setw(2) << std::setfill('0') << (int)bulk_read[i];
+    std::cout << std::dec << std::endl;
+
+    // actuator 1 is in wheel mode, 3 is in multi-turn mode; 2 (an AX-12) does
+    // not answer the bulk read, but answers its own read, in joint mode
+    ReplayController controller_1;
+    controller_1.replies.push_back(status_reply_1(1, {0x00, 0x00, 0x00, 0x00}));
+    controller_1.replies.push_back(status_reply_1(3, {0xFF, 0x0F, 0xFF, 0x0F}));
+    controller_1.replies.push_back(status_reply_1(2, {0x00, 0x00, 0xFF, 0x03}));
+    std::vector<ReadStatus> statuses;
+    std::vector<OperatingMode> modes = operating_modes<Protocol1>(controller_1, ids, statuses);
+    for (size_t i = 0; i < ids.size(); ++i)
+        std::cout << "\tid " << (int)ids[i] << ": " << mode2str(modes[i]) << " (" << status2str(statuses[i]) << ")" << std::endl;
+    std::cout << "\t" << controller_1.sent << " packet(s) sent" << std::endl;
+
+    ReplayController controller_2;
+    controller_2.replies.push_back(status_reply_2(1, {3}));
+    controller_2.replies.push_back(status_reply_2(2, {1}));
+    controller_2.replies.push_back(status_reply_2(3, {4}));
+    modes = operating_modes<Protocol2>(controller_2, ids, statuses);
+    for (size_t i = 0; i < ids.size(); ++i)
+        std::cout << "\tid " << (int)ids[i] << ": " << mode2str(modes[i]) << " (" << status2str(statuses[i]) << ")" << std::endl;
+    std::cout << "\t" << controller_2.sent << " packet(s) sent" << std::endl;
+}
+
+void test_batch_1()
+{
+    std::cout << "Batched writes and reads of mixed models" << std::endl;
+
+    // the goal position is at the same place for these three models
+    std::vector<std::shared_ptr<servos::BaseServo<Protocol1>>> servos_1 = {
+        std::make_shared<servos::Mx28>(1), std::make_shared<servos::Mx64>(2), std::make_shared<servos::Ax12>(3)};
+    BatchWrite<Protocol1> writes;
+    for (auto servo : servos_1)
+        writes.add(servo->id(), servo->goal_position_field(), servo->goal_position_angle_data(3.14159265));
+    std::vector<InstructionPacket<Protocol1>> packets = writes.packets();
+    std::cout << "\t" << packets.size() << " sync write(s), of " << (packets[0].size() - 8) / 3 << " actuators" << std::endl;
+
+    // actuator 2 first sends a corrupted reply (size mismatch), and is then
+    // read individually; actuator 1 appears in two bulk reads
+    BatchRead<Protocol1> reads;
+    reads.add(1, servos::Mx28::field_present_position());
+    reads.add(2, servos::Mx64::field_present_position());
+    reads.add(1, servos::Mx28::field_torque_enable());
+
+    ReplayController controller;
+    controller.replies.push_back(status_reply_1(1, {0x00, 0x08}));
+    controller.replies.push_back(status_reply_1(2, {0x00}));
+    controller.replies.push_back(status_reply_1(1, {0x01}));
+    controller.replies.push_back(status_reply_1(2, {0xFF, 0x03}));
+
+    std::vector<StatusPacket<Protocol1>> replies;
+    std::vector<ReadStatus> statuses;
+    reads.read(controller, replies, statuses);
+    for (size_t i = 0; i < statuses.size(); ++i) {
+        std::cout << "\tread " << i << ": " << status2str(statuses[i]);
+        if (statuses[i] == ReadStatus::ok)
+            std::cout << ", " << replies[i].parameters().size() << " byte(s)";
+        std::cout << std::endl;
+    }
+    std::cout << "\t" << controller.sent << " packet(s) sent" << std::endl;
+
+    // the AX-12 does not know the bulk read: it is read on its own, without
+    // waiting for it in the bulk read
+    BatchRead<Protocol1> mixed;
+    for (auto servo : servos_1)
+        mixed.add(servo->id(), servo->present_position_field(), servo->supports_bulk_read());
+    std::vector<std::vector<size_t>> bulk_reads;
+    mixed.packets(bulk_reads);
+    ReplayController mixed_controller;
+    mixed_controller.replies.push_back(status_reply_1(1, {0x00, 0x08}));
+    mixed_controller.replies.push_back(status_reply_1(2, {0x00, 0x04}));
+    mixed_controller.replies.push_back(status_reply_1(3, {0xFF, 0x01}));
+    mixed.read(mixed_controller, replies, statuses);
+    std::cout << "\tbulk read of " << bulk_reads[0].size() << " actuators, then";
+    for (size_t i = 0; i < statuses.size(); ++i)
+        std::cout << " " << status2str(statuses[i]);
+    std::cout << ", " << mixed_controller.sent << " packet(s) sent, "
+              << mixed_controller.timeouts << " timeout(s)" << std::endl;
+
+    // nobody answers after actuator 1: the bus is only waited for once
+    ReplayController silent_controller;
+    silent_controller.replies.push_back(status_reply_1(1, {0x00, 0x08}));
+    std::vector<Protocol1::id_t> chained = {1, 2, 3, 4};
+    std::vector<ReadResult<Protocol1, uint16_t>> results = recv_results<uint16_t, Protocol1>(silent_controller, chained);
+    std::cout << "\tchained replies:";
+    for (size_t i = 0; i < results.size(); ++i)
+        std::cout << " " << status2str(results[i].status);
+    std::cout << ", " << silent_controller.timeouts << " timeout(s)" << std::endl;
+}
+
+void test_batch_write_2()
+{
+    std::cout << "Goal positions of mixed models (protocol 2)" << std::endl;
+
+    // the goal position is at address 116 for the MX-28 and 596 for the Pro
+    std::vector<std::shared_ptr<servos::BaseServo<Protocol2>>> servos = {
+        std::make_shared<servos::Mx28P2>(1), std::make_shared<servos::ProL5430S500>(2), std::make_shared<servos::Mx28P2>(3)};
+    BatchWrite<Protocol2> batch;
+    for (auto servo : servos)
+        batch.add(servo->id(), servo->goal_position_field(), servo->goal_position_angle_data(0.5));
+
+    std::cout << "\t" << batch.groups() << " group(s), " << batch.packets().size() << " sync write(s)" << std::endl;
+    std::vector<InstructionPacket<Protocol2>> packets = batch.packets(true);
+    std::cout << "\tbulk write:";
+    for (size_t i = 0; i < packets[0].size(); ++i)
+        std::cout << " " << std::hex << std::setw(2) << std::setfill('0') << (int)packets[0][i];
+    std::cout << std::dec << std::endl;
+}
+
+void test_monitor_1()
+{
+    std::cout << "Telemetry of three actuators (protocol 1)" << std::endl;
+
+    Monitor<Protocol1> monitor;
+    monitor.add(1, "position", servos::Mx28::field_present_position());
+    monitor.add(2, "position", servos::Mx28::field_present_position());
+    monitor.add(3, "load", Field<Protocol1>(40, 2), true);
+
+    // actuator 2 does not answer the bulk read, nor the individual read
+    ReplayController controller;
+    controller.replies.push_back(status_reply_1(1, {0x00, 0x02}));
+    controller.replies.push_back(status_reply_1(3, {0xFE, 0xFF}));
+
+    std::stringstream csv;
+    Monitor<Protocol1>::Report report = monitor.run(controller, 1000, csv, MonitorFormat::csv, 1);
+    std::string header, row;
+    std::getline(csv, header);
+    std::getline(csv, row);
+    std::cout << "\t" << header << std::endl;
+    std::cout << "\t" << row.substr(row.find(',')) << std::endl;
+    std::cout << "\t" << report.samples << " sample(s), " << report.failed_reads
+              << " failed read(s), " << controller.sent << " packet(s) sent" << std::endl;
+
+    Monitor<Protocol1>::Sample sample;
+    monitor.sample(ReplayController(), 0, sample);
+    std::stringstream binary;
+    monitor.write(binary, sample, MonitorFormat::binary);
+    std::cout << "\tbinary record: " << binary.str().size() << " bytes" << std::endl;
+}
+
+void test_benchmark_1()
+{
+    std::cout << "Latency statistics" << std::endl;
+
+    LatencyStats stats;
+    for (int i = 1; i <= 10; ++i)
+        stats.add(i * 1e-3);
+    stats.add_failure();
+    std::cout << "\t" << stats.count() << " ok, " << stats.failures() << " failed, median "
+              << stats.percentile(0.5) * 1e3 << " ms, histogram:";
+    std::vector<size_t> counts = stats.histogram(3);
+    for (size_t i = 0; i < counts.size(); ++i)
+        std::cout << " " << counts[i];
+    std::cout << std::endl;
+
+    // actuator 1 answers two pings out of three, the second time with an
+    // input voltage error (which still completes the round trip)
+    std::vector<uint8_t> voltage_error = {0xFF, 0xFF, 0x01, 0x02, 0x01, 0xFB};
+    ReplayController controller;
+    controller.replies.push_back(status_reply_1(1, {}));
+    controller.replies.push_back(status_reply_1(2, {}));
+    controller.replies.push_back(voltage_error);
+    LatencyStats pings = bench_transactions(controller, 1, instructions::Ping<Protocol1>(1), 3);
+    std::cout << "\tpings: " << pings.count() << " ok (" << pings.servo_errors() << " with an error), "
+              << pings.failures() << " failed, " << controller.sent << " packet(s) sent" << std::endl;
+}
+
+void test_bus_manager_1()
+{
+    std::cout << "Reads on two buses (protocol 1)" << std::endl;
+
+    BusManager<Protocol1, ReplayController> buses;
+    buses.add_bus();
+    buses.add_bus();
+    // the same id on both buses
+    buses.controller(0).replies.push_back(status_reply_1(1, {0x00, 0x01}));
+    buses.controller(1).replies.push_back(status_reply_1(1, {0x00, 0x02}));
+
+    std::vector<BusId<Protocol1>> ids = {{1, 1}, {0, 1}};
+    std::vector<Field<Protocol1>> fields(ids.size(), servos::Mx28::field_present_position());
+    std::vector<StatusPacket<Protocol1>> replies;
+    std::vector<ReadStatus> statuses;
+    buses.read(ids, fields, replies, statuses);
+    for (size_t i = 0; i < ids.size(); ++i) {
+        uint16_t position = 0;
+        if (ReadStatus::ok == statuses[i])
+            Protocol1::unpack_data(replies[i].parameters().data(), 2, 0, position);
+        std::cout << "\tbus " << ids[i].bus << ", id " << (int)ids[i].id << ": " << position << std::endl;
+    }
+
+    try {
+        buses.cycle([](size_t bus, const ReplayController&) {
+            if (1 == bus)
+                throw errors::Error("failure on bus 1");
+        });
+    }
+    catch (const errors::Error& e) {
+        std::cout << "\tcaught: " << e.msg() << std::endl;
+    }
+}
+
+void test_send_queue_1()
+{
+    std::cout << "Send queue (protocol 1)" << std::endl;
+
+    // two sync writes, then a read of actuator 3
+    std::vector<std::shared_ptr<servos::BaseServo<Protocol1>>> servos = {
+        std::make_shared<servos::Mx28>(1), std::make_shared<servos::Mx28>(2)};
+    BatchWrite<Protocol1> batch;
+    for (auto servo : servos) {
+        batch.add(servo->id(), servo->goal_position_field(), servo->goal_position_angle_data(1.0));
+        batch.add(servo->id(), servo->torque_enable_field(), std::vector<uint8_t>(1, 1));
+    }
+    SendQueue<Protocol1> queue;
+    std::vector<InstructionPacket<Protocol1>> packets = batch.packets();
+    for (size_t i = 0; i < packets.size(); ++i)
+        queue.push(packets[i]);
+    queue.push(instructions::Read<Protocol1>(3, 36, 2), 3);
+    std::cout << "\t" << queue.size() << " packets, " << queue.buffer().size() << " bytes, "
+              << queue.expected_replies().size() << " expected reply" << std::endl;
+
+    ReplayController controller;
+    controller.replies.push_back(status_reply_1(3, {0x00, 0x02}));
+    std::vector<StatusPacket<Protocol1>> replies;
+    std::vector<ReadStatus> statuses;
+    queue.exchange(controller, replies, statuses);
+    std::cout << "\t" << controller.sent << " write(s), reply of actuator " << (int)replies[0].id()
+              << (ReadStatus::ok == statuses[0] ? " ok" : " failed") << std::endl;
+}
+
+void test_pipeline_1()
+{
+    std::cout << "Transaction pipeline (protocol 1)" << std::endl;
+
+    TransactionPipeline<Protocol1> pipeline;
+    pipeline.set_max_in_flight(2);
+    pipeline.submit(instructions::Write<Protocol1>(Protocol1::broadcast_id, 25, std::vector<uint8_t>(1, 1)));
+    size_t first = pipeline.submit(instructions::Read<Protocol1>(1, 36, 2), 1);
+    size_t second = pipeline.submit(instructions::Read<Protocol1>(2, 36, 2), 2);
+    size_t third = pipeline.submit(instructions::Read<Protocol1>(1, 43, 1), 1);
+
+    // actuator 2 replies before actuator 1
+    ReplayController controller;
+    controller.replies.push_back(status_reply_1(2, {0x00, 0x02}));
+    controller.replies.push_back(status_reply_1(1, {0x00, 0x01}));
+    controller.replies.push_back(status_reply_1(1, {0x28}));
+    std::vector<StatusPacket<Protocol1>> replies;
+    std::vector<ReadStatus> statuses;
+    size_t writes = pipeline.run(controller, replies, statuses);
+
+    std::cout << "\t" << writes << " write(s) for 4 transactions; replies:";
+    for (size_t i : {first, second, third})
+        std::cout << " " << (int)replies[i].id() << (ReadStatus::ok == statuses[i] ? "/ok" : "/failed")
+                  << "/" << replies[i].parameters().size() << "B";
+    std::cout << std::endl;
+}
+
+// Controller whose replies come through a pipe, to be watched by an event loop
+struct PipeController {
+    PipeController()
+    {
+        if (pipe(fds) != 0)
+            throw errors::Error("PipeController: could not create the pipe");
+        fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    }
+
+    ~PipeController()
+    {
+        close(fds[0]);
+        close(fds[1]);
+    }
+
+    int fd() const { return fds[0]; }
+
+    void send(const uint8_t*, size_t) const { ++sent; }
+
+    // make a reply available on the file descriptor
+    void reply(const std::vector<uint8_t>& packet) const
+    {
+        if (write(fds[1], packet.data(), packet.size()) != (ssize_t)packet.size())
+            throw errors::Error("PipeController: could not write the reply");
+    }
+
+    int fds[2];
+    mutable size_t sent = 0;
+};
+
+void test_async_bus_1()
+{
+    std::cout << "Asynchronous transactions (protocol 1)" << std::endl;
+
+    PipeController controller;
+    AsyncBus<Protocol1, PipeController> bus(controller, 0.001);
+
+    std::vector<std::string> events;
+    bus.submit(instructions::Read<Protocol1>(1, 36, 2), 1, [&events](const AsyncResult<Protocol1>& result) {
+        events.push_back(ReadStatus::ok == result.status ? "read ok" : "read failed");
+    });
+    std::future<AsyncResult<Protocol1>> ping = bus.submit(instructions::Ping<Protocol1>(2), 2);
+    std::cout << "\tafter submit: " << controller.sent << " packet(s) sent, " << bus.pending() << " pending" << std::endl;
+
+    // the reply arrives in two parts
+    std::vector<uint8_t> reply = status_reply_1(1, {0x00, 0x02});
+    controller.reply(std::vector<uint8_t>(reply.begin(), reply.begin() + 3));
+    bus.on_readable();
+    controller.reply(std::vector<uint8_t>(reply.begin() + 3, reply.end()));
+    bus.on_readable();
+    std::cout << "\tafter the reply: " << (events.empty() ? "no event" : events[0]) << ", "
+              << controller.sent << " packet(s) sent" << std::endl;
+
+    // actuator 2 does not answer
+    bus.run();
+    std::cout << "\tping: " << (ReadStatus::timeout == ping.get().status ? "timeout" : "answered")
+              << ", " << bus.pending() << " pending" << std::endl;
+
+    // a callback that throws does not stall the bus
+    try {
+        bus.submit(instructions::Action<Protocol1>(Protocol1::broadcast_id), [](const AsyncResult<Protocol1>&) {
+            throw errors::Error("callback error");
+        });
+    }
+    catch (const errors::Error& e) {
+        std::cout << "\t" << e.msg();
+    }
+    size_t sent = controller.sent;
+    bus.submit(instructions::Action<Protocol1>(Protocol1::broadcast_id), AsyncBus<Protocol1, PipeController>::callback_t());
+    std::cout << ", then " << controller.sent - sent << " packet(s) sent" << std::endl;
+}
+
+#ifdef __cpp_impl_coroutine
+BusTask read_then_write(CoroutineBus<Protocol1, PipeController>& bus, std::vector<std::string>& events)
+{
+    ReadResult<Protocol1, uint16_t> position = co_await bus.read<uint16_t>(1, servos::Mx28::field_present_position());
+    events.push_back("position " + std::to_string(position.value));
+    AsyncResult<Protocol1> written = co_await bus.write(1, servos::Mx28::field_goal_position(), (uint16_t)(position.value + 1));
+    events.push_back(std::string("write ") + status2str(written.status));
+}
+
+void test_coroutines_1()
+{
+    std::cout << "Coroutines (protocol 1)" << std::endl;
+
+    PipeController controller;
+    CoroutineBus<Protocol1, PipeController> bus(controller, 0.001);
+    std::vector<std::string> events;
+
+    controller.reply(status_reply_1(1, {0x00, 0x02}));
+    controller.reply(status_reply_1(1, {}));
+    BusTask task = read_then_write(bus, events);
+    std::cout << "\tstarted, " << controller.sent << " packet(s) sent" << std::endl;
+    bus.run(task);
+    for (size_t i = 0; i < events.size(); ++i)
+        std::cout << "\t" << events[i] << std::endl;
+}
+#endif
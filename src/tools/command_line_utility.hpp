@@ -4,6 +4,8 @@
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <csignal>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -20,6 +22,18 @@
 using namespace dynamixel;
 namespace po = boost::program_options;
 
+namespace dynamixel {
+    namespace {
+        // set when the user interrupts the monitor command (Ctrl+C)
+        volatile std::sig_atomic_t monitor_interrupted = 0;
+
+        extern "C" void interrupt_monitor(int)
+        {
+            monitor_interrupted = 1;
+        }
+    }
+}
+
 namespace dynamixel {
     template <class Protocol>
     class CommandLineUtility {
@@ -30,10 +44,24 @@ namespace dynamixel {
         **/
         CommandLineUtility(const std::string& name, int baudrate = get_baudrate(115200),
             double recv_timeout = 0.1, double scan_timeout = 0.05)
-            : _dyn_util(name, baudrate, recv_timeout, scan_timeout)
+            : _dyn_util(name, baudrate, recv_timeout, scan_timeout), _keep_scan(false), _scanned(false), _full_scan(false)
         {
         }
 
+        /** Keep the detected servos from one command to the next one (used by
+            the shell mode).
+
+            The bus is then only scanned by the `list` command, or when a command
+            targets servos that were not detected yet. The commands changing the
+            IDs or the baudrate of the servos, or resetting them, discard the
+            result of the previous scans.
+        **/
+        void keep_scan(bool keep)
+        {
+            _keep_scan = keep;
+            forget_scan();
+        }
+
         void select_command(po::variables_map vm)
         {
             std::string command = vm["command"].as<std::string>();
@@ -87,6 +115,7 @@ namespace dynamixel {
                 else if ("change-id" == command) {
                     check_vm(vm, "id");
                     change_id(vm["id"].as<std::vector<id_t>>());
+                    forget_scan();
                 }
                 else if ("change-baudrate" == command) {
                     check_vm(vm, "new-baudrate");
@@ -97,12 +126,14 @@ namespace dynamixel {
                             vm["new-baudrate"].as<unsigned int>());
                     else
                         change_baudrate(vm["new-baudrate"].as<unsigned int>());
+                    forget_scan();
                 }
                 else if ("factory-reset" == command) {
                     if (vm.count("id"))
                         factory_reset(vm["id"].as<std::vector<id_t>>());
                     else
                         factory_reset();
+                    forget_scan();
                 }
                 else if ("position" == command) {
                     check_vm(vm, "angle");
@@ -148,13 +179,14 @@ namespace dynamixel {
                 else if ("set-speed-sync" == command) {
                     check_vm(vm, "speed");
 
-                    // bool wheel_mode = false;
-                    // if (vm.count("wheel-mode"))
-                    //     wheel_mode = true;
+                    bool wheel_mode = false;
+                    if (vm.count("wheel-mode"))
+                        wheel_mode = true;
 
                     if (vm.count("id"))
                         speed_sync(vm["id"].as<std::vector<id_t>>(),
-                            vm["speed"].as<std::vector<double>>());
+                            vm["speed"].as<std::vector<double>>(),
+                            wheel_mode);
                 }
                 else if ("get-speed" == command) {
                     if (vm.count("id"))
@@ -189,6 +221,32 @@ namespace dynamixel {
                     else
                         torque_enable(false);
                 }
+                else if ("monitor" == command) {
+                    check_vm(vm, "fields");
+                    std::string format = vm["format"].as<std::string>();
+                    if ("csv" != format && "binary" != format)
+                        throw errors::Error("Unknown format " + format
+                            + "; use either csv or binary");
+
+                    std::vector<id_t> ids;
+                    if (vm.count("id"))
+                        ids = vm["id"].as<std::vector<id_t>>();
+                    monitor(ids,
+                        vm["fields"].as<std::vector<std::string>>(),
+                        vm.count("signed"),
+                        vm["rate"].as<double>(),
+                        vm["samples"].as<unsigned>(),
+                        vm["duration"].as<double>(),
+                        "csv" == format ? MonitorFormat::csv : MonitorFormat::binary,
+                        vm.count("output") ? vm["output"].as<std::string>() : "");
+                }
+                else if ("bench" == command) {
+                    std::vector<id_t> ids;
+                    if (vm.count("id"))
+                        ids = vm["id"].as<std::vector<id_t>>();
+                    bench(ids, vm["count"].as<unsigned>(),
+                        vm["baudrate"].as<unsigned>());
+                }
                 else if ("oscillate" == command) {
                     if (vm.count("id"))
                         oscillate(
@@ -278,12 +336,60 @@ namespace dynamixel {
             check_vm(vm, parameters);
         }
 
+        /* Scan the bus for all servos, unless a previous scan is kept (see
+           keep_scan).
+        */
+        void detect_servos()
+        {
+            if (_keep_scan && _full_scan)
+                return;
+
+            _dyn_util.detect_servos();
+            _scanned = _full_scan = true;
+        }
+
+        /* Scan the bus for the given servos. When the scans are kept, only the
+           servos that were not detected yet are searched for.
+        */
+        void detect_servos(const std::vector<id_t>& ids)
+        {
+            if (!_keep_scan || !_scanned) {
+                _dyn_util.detect_servos(ids);
+                _scanned = true;
+                _full_scan = false;
+                return;
+            }
+            // after a full scan, the servos that were not found do not exist
+            if (_full_scan)
+                return;
+
+            std::vector<id_t> missing;
+            for (auto id : ids)
+                if (!_dyn_util.servos().count(id))
+                    missing.push_back(id);
+            if (!missing.empty())
+                _dyn_util.add_servos(missing);
+        }
+
+        /// Discard the result of the previous scans (see keep_scan)
+        void forget_scan()
+        {
+            _scanned = _full_scan = false;
+        }
+
     private:
         Utility<Protocol> _dyn_util;
+        // whether the detected servos are kept from one command to the next
+        bool _keep_scan;
+        // whether a scan was done (and is still valid)
+        bool _scanned;
+        // whether all the bus was scanned (and this scan is still valid)
+        bool _full_scan;
 
         void list()
         {
             _dyn_util.detect_servos();
+            _scanned = _full_scan = true;
             std::map<typename Protocol::id_t, std::shared_ptr<BaseServo<Protocol>>>
                 actuators = _dyn_util.servos();
 
@@ -298,6 +404,8 @@ namespace dynamixel {
         void list(std::vector<id_t> ids)
         {
             _dyn_util.detect_servos(ids);
+            _scanned = true;
+            _full_scan = false;
             std::map<typename Protocol::id_t, std::shared_ptr<BaseServo<Protocol>>>
                 actuators = _dyn_util.servos();
 
@@ -343,7 +451,7 @@ namespace dynamixel {
         void write(typename Protocol::address_t address,
             long long int data, unsigned short size, bool is_signed)
         {
-            _dyn_util.detect_servos();
+            detect_servos();
 
             if (1 == size) { // one byte of data, unsigned
                 _dyn_util.template write<uint8_t>(address, data);
@@ -369,34 +477,17 @@ namespace dynamixel {
             unsigned short size, bool is_signed)
         {
             if (1 == size) { // one byte of data, unsigned
-                for (auto id : ids) {
-                    std::cout
-                        << (unsigned short)_dyn_util.template read<uint8_t>(
-                               id, address)
-                        << "\n";
-                }
+                print_values(_dyn_util.template read_results<uint8_t>(ids, address));
             }
             else if (2 == size) { // two bytes of data, unsigned
-                for (auto id : ids) {
-                    std::cout
-                        << _dyn_util.template read<uint16_t>(id, address)
-                        << "\n";
-                }
+                print_values(_dyn_util.template read_results<uint16_t>(ids, address));
             }
             else if (4 == size) { // four bytes of data, both unsigned and signed
                 if (is_signed) {
-                    for (auto id : ids) {
-                        std::cout
-                            << _dyn_util.template read<uint32_t>(id, address)
-                            << "\n";
-                    }
+                    print_values(_dyn_util.template read_results<uint32_t>(ids, address));
                 }
                 else {
-                    for (auto id : ids) {
-                        std::cout
-                            << _dyn_util.template read<int32_t>(id, address)
-                            << "\n";
-                    }
+                    print_values(_dyn_util.template read_results<int32_t>(ids, address));
                 }
             }
             else {
@@ -408,20 +499,20 @@ namespace dynamixel {
         void read(typename Protocol::address_t address, unsigned short size,
             bool is_signed)
         {
-            _dyn_util.detect_servos();
+            detect_servos();
 
             if (1 == size) { // one byte of data, unsigned
-                print_data(_dyn_util.template read<uint8_t>(address));
+                print_data(_dyn_util.template read_results<uint8_t>(address));
             }
             else if (2 == size) { // two bytes of data, unsigned
-                print_data(_dyn_util.template read<uint16_t>(address));
+                print_data(_dyn_util.template read_results<uint16_t>(address));
             }
             else if (4 == size) { // four bytes of data, both unsigned and signed
                 if (is_signed) {
-                    print_data(_dyn_util.template read<uint32_t>(address));
+                    print_data(_dyn_util.template read_results<uint32_t>(address));
                 }
                 else {
-                    print_data(_dyn_util.template read<int32_t>(address));
+                    print_data(_dyn_util.template read_results<int32_t>(address));
                 }
             }
             else {
@@ -430,16 +521,41 @@ namespace dynamixel {
             }
         }
 
+        /// Print the ID and the value (or the failure) of each result
         template <typename T>
-        void print_data(std::vector<std::pair<id_t, T>> pairs)
+        void print_data(const std::vector<ReadResult<Protocol, T>>& results)
         {
-            for (auto pair : pairs)
-                std::cout << pair.first << "\t" << (long long int)pair.second << "\n";
+            for (auto result : results) {
+                std::cout << (unsigned int)result.id << "\t";
+                print_result(result);
+            }
+        }
+
+        /// Print the value (or the failure) of each result
+        template <typename T>
+        void print_values(const std::vector<ReadResult<Protocol, T>>& results)
+        {
+            for (auto result : results)
+                print_result(result);
+        }
+
+        template <typename T>
+        void print_result(const ReadResult<Protocol, T>& result)
+        {
+            if (result.has_value())
+                std::cout << (long long int)result.value;
+            if (!result.ok())
+                std::cout << (result.has_value() ? "\t" : "") << "("
+                          << status2str(result.status) << ")";
+            if (ReadStatus::servo_error == result.status)
+                std::cout << " "
+                          << Protocol::status_error_message(result.id, result.error_byte);
+            std::cout << "\n";
         }
 
         void change_id(const std::vector<id_t>& ids)
         {
-            _dyn_util.detect_servos();
+            detect_servos();
 
             if (0 == ids.size() % 2) {
                 for (unsigned i = 0; i + 1 < ids.size(); i += 2) {
@@ -457,7 +573,7 @@ namespace dynamixel {
 
         void change_baudrate(const std::vector<id_t>& ids, unsigned int baudrate)
         {
-            _dyn_util.detect_servos(ids);
+            detect_servos(ids);
 
             for (auto id : ids) {
                 _dyn_util.change_baudrate(id, baudrate);
@@ -465,13 +581,13 @@ namespace dynamixel {
         }
         void change_baudrate(unsigned int baudrate)
         {
-            _dyn_util.detect_servos();
+            detect_servos();
             _dyn_util.change_baudrate(Protocol::broadcast_id, baudrate);
         }
 
         void factory_reset(const std::vector<id_t>& ids)
         {
-            _dyn_util.detect_servos(ids);
+            detect_servos(ids);
 
             for (auto id : ids) {
                 _dyn_util.factory_reset(id);
@@ -479,18 +595,18 @@ namespace dynamixel {
         }
         void factory_reset()
         {
-            _dyn_util.detect_servos();
+            detect_servos();
             _dyn_util.factory_reset(Protocol::broadcast_id);
         }
 
         void position(const std::vector<id_t>& ids, const std::vector<double>& angles)
         {
             if (angles.size() == 1) {
-                _dyn_util.detect_servos(ids);
+                detect_servos(ids);
                 _dyn_util.set_angle(ids, angles.at(0));
             }
             else if (ids.size() == angles.size()) {
-                _dyn_util.detect_servos(ids);
+                detect_servos(ids);
                 _dyn_util.set_angle(ids, angles);
             }
             else
@@ -505,7 +621,7 @@ namespace dynamixel {
         void position(const std::vector<double>& angles)
         {
             if (angles.size() == 1) {
-                _dyn_util.detect_servos();
+                detect_servos();
                 _dyn_util.set_angle(angles.at(0));
             }
             else
@@ -518,7 +634,7 @@ namespace dynamixel {
         void position_sync(const std::vector<id_t>& ids, const std::vector<double>& angles)
         {
             if (ids.size() == angles.size()) {
-                _dyn_util.detect_servos(ids);
+                detect_servos(ids);
                 _dyn_util.set_angle_sync(ids, angles);
             }
             else
@@ -533,7 +649,7 @@ namespace dynamixel {
             if (ids.size() == 0)
                 return;
 
-            _dyn_util.detect_servos(ids);
+            detect_servos(ids);
 
             std::vector<double> positions;
             positions = _dyn_util.get_angle(ids);
@@ -546,7 +662,7 @@ namespace dynamixel {
 
         void print_position()
         {
-            _dyn_util.detect_servos();
+            detect_servos();
 
             std::pair<std::vector<id_t>, std::vector<double>> angles;
             angles = _dyn_util.get_angle();
@@ -561,7 +677,7 @@ namespace dynamixel {
         {
             std::chrono::steady_clock::time_point time_before;
             std::chrono::steady_clock::time_point time_after;
-            _dyn_util.detect_servos();
+            detect_servos();
             std::pair<std::vector<id_t>, std::vector<double>> angles;
             angles = _dyn_util.get_angle_bulk();
             std::cout << "Angular positions of the actuators (rad):" << std::endl;
@@ -574,11 +690,11 @@ namespace dynamixel {
             bool wheel_mode = false)
         {
             if (speeds.size() == 1) {
-                _dyn_util.detect_servos(ids);
+                detect_servos(ids);
                 _dyn_util.set_speed(ids, speeds.at(0), wheel_mode);
             }
             else if (ids.size() == speeds.size()) {
-                _dyn_util.detect_servos(ids);
+                detect_servos(ids);
                 _dyn_util.set_speed(ids, speeds, wheel_mode);
             }
             else
@@ -593,7 +709,7 @@ namespace dynamixel {
         void speed(const std::vector<double>& speeds, bool wheel_mode = false)
         {
             if (speeds.size() == 1) {
-                _dyn_util.detect_servos();
+                detect_servos();
                 _dyn_util.set_speed(speeds.at(0), wheel_mode);
             }
             else
@@ -603,11 +719,12 @@ namespace dynamixel {
                           << std::endl;
         }
 
-        void speed_sync(const std::vector<id_t>& ids, const std::vector<double>& speeds)
+        void speed_sync(const std::vector<id_t>& ids,
+            const std::vector<double>& speeds, bool wheel_mode = false)
         {
             if (ids.size() == speeds.size()) {
-                _dyn_util.detect_servos(ids);
-                _dyn_util.set_speed_sync(ids, speeds);
+                detect_servos(ids);
+                _dyn_util.set_speed_sync(ids, speeds, wheel_mode);
             }
             else
                 std::cout << "Usage for set-speed-sync command (with IDs):\n"
@@ -621,7 +738,7 @@ namespace dynamixel {
             if (ids.size() == 0)
                 return;
 
-            _dyn_util.detect_servos(ids);
+            detect_servos(ids);
 
             std::vector<double> speeds;
             speeds = _dyn_util.get_speed(ids);
@@ -634,7 +751,7 @@ namespace dynamixel {
 
         void print_speed()
         {
-            _dyn_util.detect_servos();
+            detect_servos();
 
             std::pair<std::vector<id_t>, std::vector<double>> speeds
                 = _dyn_util.get_speed();
@@ -648,7 +765,7 @@ namespace dynamixel {
 
         void torque_enable(const std::vector<id_t>& ids, bool enable = true)
         {
-            _dyn_util.detect_servos(ids);
+            detect_servos(ids);
 
             for (auto id : ids) {
                 _dyn_util.torque_enable(id, enable);
@@ -657,13 +774,13 @@ namespace dynamixel {
 
         void torque_enable(bool enable = true)
         {
-            _dyn_util.detect_servos();
+            detect_servos();
             _dyn_util.torque_enable(Protocol::broadcast_id, enable);
         }
 
         void print_torque_enable(const std::vector<id_t>& ids)
         {
-            _dyn_util.detect_servos(ids);
+            detect_servos(ids);
             std::vector<bool> enabled = _dyn_util.get_torque_enable(ids);
 
             if (ids.size() == 1) {
@@ -683,7 +800,7 @@ namespace dynamixel {
 
         void print_torque_enable()
         {
-            _dyn_util.detect_servos();
+            detect_servos();
             std::pair<std::vector<id_t>, std::vector<bool>> response
                 = _dyn_util.get_torque_enable();
 
@@ -706,7 +823,7 @@ namespace dynamixel {
         {
             using namespace std::chrono;
 
-            _dyn_util.detect_servos();
+            detect_servos();
 
             steady_clock::time_point t1 = steady_clock::now();
             long long int t = 0;
@@ -732,6 +849,154 @@ namespace dynamixel {
             else
                 _dyn_util.set_angle(ids, angle);
         }
+
+        /* Measure the latency of the transactions with each servo, and the
+           duration of a control cycle (sync/bulk write of the goal positions
+           and read of the present positions) for all of them.
+        */
+        void bench(std::vector<id_t> ids, unsigned count, unsigned baudrate)
+        {
+            if (ids.empty()) {
+                detect_servos();
+                for (auto servo : _dyn_util.servos())
+                    ids.push_back(servo.first);
+            }
+            else
+                detect_servos(ids);
+
+            const Usb2Dynamixel& controller = _dyn_util.serial_interface();
+            BatchWrite<Protocol> writes;
+            BatchRead<Protocol> reads;
+
+            std::cout << "Baudrate: " << baudrate << ", " << count
+                      << " transactions per measure" << std::endl;
+            for (auto id : ids) {
+                std::shared_ptr<BaseServo<Protocol>> servo = _dyn_util.servos().at(id);
+                Field<Protocol> goal = servo->goal_position_field();
+                Field<Protocol> present = servo->present_position_field();
+
+                // the return delay time is counted in units of 2 us
+                std::cout << "\nActuator " << id << " (" << servo->model_name()
+                          << "), return delay time: ";
+                StatusPacket<Protocol> delay;
+                protocols::DecodeReport report;
+                controller.send(servo->get_return_delay_time());
+                if (controller.recv(delay, report) && delay.id() == id)
+                    std::cout << 2 * servo->parse_return_delay_time(delay) << " us" << std::endl;
+                else
+                    std::cout << "unknown (no reply)" << std::endl;
+
+                std::cout << "Ping:" << std::endl;
+                bench_transactions(controller, id, Ping<Protocol>(id), count)
+                    .print(std::cout);
+                std::cout << "Read (present position):" << std::endl;
+                bench_transactions(controller, id,
+                    Read<Protocol>(id, present.address, present.size), count)
+                    .print(std::cout);
+
+                // write back the current goal position, so that nothing moves
+                StatusPacket<Protocol> status;
+                controller.send(Read<Protocol>(id, goal.address, goal.size));
+                if (!controller.recv(status) || status.parameters().size() != goal.size) {
+                    std::cout << "Write: could not read the goal position" << std::endl;
+                    continue;
+                }
+                std::cout << "Write (goal position):" << std::endl;
+                LatencyStats write_stats = bench_transactions(controller, id,
+                    Write<Protocol>(id, goal.address, status.parameters()), count);
+                write_stats.print(std::cout);
+                if (0 == write_stats.count())
+                    std::cout << "  (the actuator may not reply to writes; "
+                              << "see its status return level)" << std::endl;
+
+                writes.add(id, goal, status.parameters());
+                reads.add(id, present, servo->supports_bulk_read());
+            }
+
+            if (0 == reads.size())
+                return;
+            std::cout << "\nCycle (write goal positions, read present positions of "
+                      << reads.size() << " actuators):" << std::endl;
+            LatencyStats cycles = bench_cycles(controller, writes, reads, count,
+                BatchWriteInstructions<Protocol>::has_bulk_write);
+            cycles.print(std::cout);
+            if (cycles.count() > 0)
+                std::cout << "Achievable loop rate: " << 1 / cycles.mean() << " Hz"
+                          << std::endl;
+        }
+
+        /* Location of a field monitored on the given servo: either the name of
+           a field that each model defines (position, goal-position, speed,
+           moving-speed, torque-enable) or ADDRESS:SIZE. The speed is the
+           measured one (present speed); moving-speed is the commanded one.
+        */
+        Field<Protocol> monitor_field(const BaseServo<Protocol>& servo,
+            const std::string& spec)
+        {
+            if ("position" == spec)
+                return servo.present_position_field();
+            else if ("goal-position" == spec)
+                return servo.goal_position_field();
+            else if ("speed" == spec)
+                return servo.present_speed_field();
+            else if ("moving-speed" == spec)
+                return servo.moving_speed_field();
+            else if ("torque-enable" == spec)
+                return servo.torque_enable_field();
+
+            std::istringstream stream(spec);
+            unsigned address = 0, size = 0;
+            char separator = 0;
+            if (!(stream >> address >> separator >> size) || ':' != separator
+                || !stream.eof())
+                throw errors::Error("Invalid field " + spec + "; expected one of "
+                    + "position, goal-position, speed, moving-speed, torque-enable or ADDRESS:SIZE");
+            return Field<Protocol>(address, size);
+        }
+
+        void monitor(std::vector<id_t> ids,
+            const std::vector<std::string>& fields, bool is_signed, double rate,
+            unsigned samples, double duration, MonitorFormat format,
+            const std::string& output)
+        {
+            if (ids.empty()) {
+                detect_servos();
+                for (auto servo : _dyn_util.servos())
+                    ids.push_back(servo.first);
+            }
+            else
+                detect_servos(ids);
+
+            Monitor<Protocol> monitor;
+            for (auto id : ids) {
+                std::shared_ptr<BaseServo<Protocol>> servo = _dyn_util.servos().at(id);
+                for (auto spec : fields)
+                    monitor.add(id, spec, monitor_field(*servo, spec), is_signed,
+                        servo->supports_bulk_read());
+            }
+
+            std::ofstream file;
+            if (!output.empty()) {
+                file.open(output.c_str(), std::ios::out | std::ios::binary);
+                if (!file)
+                    throw errors::Error("Could not open " + output);
+            }
+            std::ostream& out = output.empty() ? std::cout : file;
+
+            // Ctrl+C stops the sampling, and the report is still printed
+            monitor_interrupted = 0;
+            void (*previous_handler)(int) = std::signal(SIGINT, interrupt_monitor);
+            typename Monitor<Protocol>::Report report = monitor.run(
+                _dyn_util.serial_interface(), rate, out, format, samples, duration,
+                &monitor_interrupted);
+            std::signal(SIGINT, previous_handler);
+
+            // the samples may be on the standard output
+            std::cerr << report.samples << " samples in " << report.duration
+                      << " s: " << report.rate() << " Hz (target: " << rate
+                      << " Hz), " << report.missed << " missed samples, "
+                      << report.failed_reads << " failed reads" << std::endl;
+        }
     };
 } // namespace dynamixel
 
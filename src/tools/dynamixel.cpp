@@ -9,6 +9,8 @@
 
 #include <stdexcept>
 
+#include <unistd.h>
+
 using namespace dynamixel;
 namespace po = boost::program_options;
 
@@ -192,6 +194,63 @@ void display_help(const std::string program_name,
         "EXAMPLE: "+program_name+" oscillate --periods 3\n"
         "\twill make all connected servos turn during 3 periods using the\n"
         "\tdefault parameters for the sinusoid";
+    command_help["monitor"] =
+        "Sample some fields of the servos at a fixed rate, and write one\n"
+        "timestamped row per sample, until --samples rows are written, --duration\n"
+        "seconds elapsed or Ctrl+C is hit. The fields are read with bulk or sync\n"
+        "reads.\n"
+        "\n"
+        "Useful options:\n"
+        "\t--fields fields read on each servo: position, goal-position, speed\n"
+        "\t\t(measured), moving-speed (commanded), torque-enable (whatever\n"
+        "\t\ttheir address for each model) or ADDRESS:SIZE, SIZE being 1, 2\n"
+        "\t\tor 4 bytes\n"
+        "\t--id to restrict the sampling to a set of actuators\n"
+        "\t--signed if the values are signed\n"
+        "\t--rate target number of samples per second (0: as fast as possible)\n"
+        "\t--samples, --duration\n"
+        "\t--format csv (default) or binary; a binary record holds the time\n"
+        "\t\t(double) and, for each column, the status of the read (uint8) and\n"
+        "\t\tthe value (int32), in little endian, after the header line\n"
+        "\t--output file receiving the samples (default: standard output)\n"
+        "The achieved rate, the number of missed samples (periods skipped\n"
+        "because the reads took longer) and of failed reads are printed at the\n"
+        "end, on the error output.\n"
+        "\n"
+        "EXAMPLE: "+program_name+" monitor --fields position 43:1 --rate 100\n"
+        "\t--duration 10 --output log.csv\n"
+        "\twrites the position and temperature of all the servos (protocol 1)\n"
+        "\tin log.csv, 100 times per second during 10 s";
+    command_help["bench"] =
+        "Measure the latencies on the bus, to check the cabling and the\n"
+        "interface. For each servo, the round-trip times of --count pings,\n"
+        "reads (of the present position) and writes (of the goal position, with\n"
+        "its current value) are given with a histogram, along with the return\n"
+        "delay time of the servo. Then, the duration of a control cycle (writing\n"
+        "the goal positions of all servos and reading their present positions,\n"
+        "with sync or bulk instructions) gives the loop rate that can be\n"
+        "achieved at this baudrate.\n"
+        "\n"
+        "EXAMPLE: "+program_name+" bench --id 1 2 3 --count 1000";
+    command_help["shell"] =
+        "Read commands from the standard input, one per line, and execute them\n"
+        "on the same connection. Each line is a command followed by its options,\n"
+        "as they would be given to "+program_name+"; the connection options\n"
+        "(--port, --baudrate, --timeout, --scan-timeout) are those given to the\n"
+        "shell command and can not be changed in the session.\n"
+        "\n"
+        "The servos found by a scan are kept for the following commands: the bus\n"
+        "is only scanned again by `list`, by a command targetting servos that\n"
+        "were not detected yet, or after `change-id`, `change-baudrate` or\n"
+        "`factory-reset`. Empty lines and text following a `#` are ignored;\n"
+        "`exit` or `quit` (or the end of the input) ends the session.\n"
+        "\n"
+        "EXAMPLES:\n"
+        "\t"+program_name+" shell\n"
+        "\tstarts an interactive session\n"
+        "\n"
+        "\t"+program_name+" shell < commands.txt\n"
+        "\texecutes the commands listed in commands.txt";
     //clang-format on
 
     // Write the command specific help message if a command is specified and it
@@ -224,6 +283,9 @@ void display_help(const std::string program_name,
             "  get-torque-enable\n"
             "  relax\n"
             "  oscillate\n"
+            "  monitor\n"
+            "  bench\n"
+            "  shell\n"
             "Use `"+program_name+" --help COMMAND` to get help for one "
             "command."
             << "\n\n"
@@ -231,6 +293,74 @@ void display_help(const std::string program_name,
     }
 }
 
+/* Execute the commands read, line by line, on the standard input (`shell`
+   command), with the same connection to the actuators.
+*/
+template <class Protocol>
+void run_shell(CommandLineUtility<Protocol>& command_line,
+    const std::string program_name, const po::options_description& desc,
+    const po::options_description& cmdline_options,
+    const po::positional_options_description& pos_desc)
+{
+    const char* connection_options[] = {"port", "baudrate", "timeout", "scan-timeout"};
+    bool interactive = isatty(STDIN_FILENO);
+    std::string line;
+
+    command_line.keep_scan(true);
+
+    while (true) {
+        if (interactive)
+            std::cout << "> " << std::flush;
+        if (!std::getline(std::cin, line))
+            break;
+
+        size_t comment = line.find('#');
+        if (comment != std::string::npos)
+            line.erase(comment);
+        std::vector<std::string> args = po::split_unix(line);
+        if (args.empty())
+            continue;
+        if ("exit" == args[0] || "quit" == args[0])
+            break;
+
+        po::variables_map vm;
+        try {
+            po::command_line_parser parser{args};
+            parser.options(cmdline_options).positional(pos_desc);
+            po::store(parser.run(), vm);
+            po::notify(vm);
+        }
+        catch (po::error& e) {
+            std::cerr << "Parsing error: " << e.what() << std::endl;
+            continue;
+        }
+
+        if (vm.count("help") || !vm.count("command")) {
+            display_help(program_name, desc, vm);
+            continue;
+        }
+        if ("shell" == vm["command"].as<std::string>()) {
+            std::cerr << "Already in a shell session" << std::endl;
+            continue;
+        }
+        for (const char* option : connection_options)
+            if (!vm[option].defaulted())
+                std::cerr << "Ignoring --" << option << ": it can not be "
+                          << "changed in a shell session" << std::endl;
+
+        try {
+            command_line.select_command(vm);
+        }
+        catch (errors::Error e) {
+            std::cerr << e.msg() << std::endl;
+        }
+        std::cout << std::flush;
+    }
+
+    if (interactive)
+        std::cout << std::endl;
+}
+
 int main(int argc, char** argv)
 {
     // Convenience definitions
@@ -297,7 +427,23 @@ int main(int argc, char** argv)
         ("phase,P", po::value<float>()->default_value(0),
             "phase shift for the oscillate command")
         ("periods,T", po::value<unsigned>()->default_value(5),
-            "number of periods for the oscillation");
+            "number of periods for the oscillation")
+        ("fields", po::value<std::vector<std::string>>()->multitoken(),
+            "fields sampled by the `monitor` command: position, goal-position, "
+            "speed (measured), moving-speed (commanded), torque-enable or ADDRESS:SIZE")
+        ("rate", po::value<double>()->default_value(50),
+            "target number of samples per second for the `monitor` command")
+        ("samples", po::value<unsigned>()->default_value(0),
+            "number of samples written by the `monitor` command (0: no limit)")
+        ("duration", po::value<double>()->default_value(0),
+            "duration of the `monitor` command, in seconds (0: no limit)")
+        ("format", po::value<std::string>()->default_value("csv"),
+            "format of the samples of the `monitor` command: csv or binary")
+        ("output,o", po::value<std::string>(),
+            "file receiving the samples of the `monitor` command (default: "
+            "standard output)")
+        ("count", po::value<unsigned>()->default_value(100),
+            "number of transactions of each measure of the `bench` command");
     // clang-format on
 
     po::options_description hidden("Hidden options");
@@ -366,7 +512,10 @@ int main(int argc, char** argv)
         CommandLineUtility<Protocol> command_line(port, posix_baudrate, timeout,
             scan_timeout);
 
-        command_line.select_command(vm);
+        if ("shell" == vm["command"].as<std::string>())
+            run_shell(command_line, argv[0], desc, cmdline_options, pos_desc);
+        else
+            command_line.select_command(vm);
     }
     catch (errors::Error e) {
         std::cerr << e.msg() << std::endl;
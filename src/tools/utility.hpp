@@ -57,7 +57,9 @@ namespace dynamixel {
             double original_timeout = _serial_interface.recv_timeout();
             _serial_interface.set_recv_timeout(_scan_timeout);
 
-            _servos = auto_detect_map<Protocol>(_serial_interface);
+            // the scan reads the beginning of the EEPROM areas into the cache
+            _eeprom.invalidate();
+            _servos = auto_detect_map<Protocol>(_serial_interface, _eeprom);
             _scanned = true;
 
             _serial_interface.set_recv_timeout(original_timeout);
@@ -83,7 +85,34 @@ namespace dynamixel {
             _serial_interface.set_recv_timeout(_scan_timeout);
 
             std::vector<typename Protocol::id_t> ids_right_type(ids.begin(), ids.end());
-            _servos = auto_detect_map<Protocol>(_serial_interface, ids_right_type);
+            _eeprom.invalidate();
+            _servos = auto_detect_map<Protocol>(_serial_interface, ids_right_type, _eeprom);
+            _scanned = true;
+
+            _serial_interface.set_recv_timeout(original_timeout);
+        }
+
+        /** Detect some servos and add them to the ones already detected.
+            Contrary to detect_servos(ids), the servos found by the previous
+            scans are kept.
+
+            @param ids vector of servo ID to be searched for
+
+            @throws dynamixel::error::UnpackError from auto_detect_map
+            @throws dynamixel::error:Error from auto_detect_map
+        **/
+        void add_servos(const std::vector<id_t>& ids)
+        {
+            double original_timeout = _serial_interface.recv_timeout();
+            _serial_interface.set_recv_timeout(_scan_timeout);
+
+            std::vector<typename Protocol::id_t> ids_right_type(ids.begin(), ids.end());
+            for (auto id : ids_right_type)
+                _eeprom.invalidate(id);
+            std::map<typename Protocol::id_t, std::shared_ptr<BaseServo<Protocol>>> found
+                = auto_detect_map<Protocol>(_serial_interface, ids_right_type, _eeprom);
+            for (auto servo : found)
+                _servos[servo.first] = servo.second;
             _scanned = true;
 
             _serial_interface.set_recv_timeout(original_timeout);
@@ -122,6 +151,7 @@ namespace dynamixel {
                     Protocol::pack_data(data)));
             StatusPacket<Protocol> status;
             _serial_interface.recv(status);
+            _eeprom.invalidate(id, address, sizeof(T));
         }
 
         /** Write a data field in all connected servo's memories.
@@ -139,18 +169,12 @@ namespace dynamixel {
         {
             check_scanned();
 
-            for (auto servo : _servos) {
-                _serial_interface.send(
-                    typename dynamixel::instructions::RegWrite<Protocol>(
-                        servo.second->id(),
-                        address,
-                        Protocol::pack_data(data)));
-                StatusPacket<Protocol> status;
-                _serial_interface.recv(status);
-            }
-
-            _serial_interface.send(
-                dynamixel::instructions::Action<Protocol>(Protocol::broadcast_id));
+            // same address and width for all: a single sync write
+            BatchWrite<Protocol> batch;
+            for (auto servo : _servos)
+                batch.add(servo.first, Field<Protocol>(address, sizeof(T)), Protocol::pack_data(data));
+            batch.send(_serial_interface);
+            _eeprom.invalidate(Protocol::broadcast_id, address, sizeof(T));
         }
 
         /** Read a given number of bytes in a servo's memory and return them.
@@ -210,24 +234,80 @@ namespace dynamixel {
         {
             check_scanned();
 
+            std::vector<typename Protocol::id_t> ids;
+            std::vector<Field<Protocol>> fields;
+            for (auto servo : _servos) {
+                ids.push_back(servo.first);
+                fields.push_back(Field<Protocol>(address, sizeof(T)));
+            }
+            std::vector<StatusPacket<Protocol>> replies = _read_fields(ids, fields, "its data");
+
             std::vector<std::pair<id_t, T>> pairs;
+            for (size_t i = 0; i < ids.size(); ++i) {
+                // unpack the data in the response and store it
+                T datum;
+                Protocol::unpack_data(replies[i].parameters(), datum);
+                pairs.push_back(std::make_pair(ids[i], datum));
+            }
 
-            for (auto servo : _servos) {
+            return pairs;
+        }
+
+        /** Read a field in all servo's memories, with a status for each servo.
+
+            Contrary to read(address), an actuator that does not answer or that
+            reports an error (e.g. an overload) does not abort the whole read:
+            its status tells what happened and the other values are kept.
+            Requires a prior detection of connected servos (@see detect_servos).
+
+            @see read(typename Protocol::address_t) for the admitted types
+
+            @param address address to the first byte to read in the servo's memory
+            @return vector of results (ID, datum and status), one per servo
+
+            @throws errors::UtilityError if you didn't detect connected servos before
+        **/
+        template <typename T>
+        std::vector<ReadResult<Protocol, T>>
+        read_results(typename Protocol::address_t address)
+        {
+            check_scanned();
+
+            std::vector<id_t> ids;
+            for (auto servo : _servos)
+                ids.push_back(servo.first);
+
+            return read_results<T>(ids, address);
+        }
+
+        /** Read a field in the memory of selected servos, with a status for
+            each servo.
+
+            @see read_results(typename Protocol::address_t)
+
+            @param ids IDs of the requested servos
+            @param address address to the first byte to read in the servo's memory
+            @return vector of results (ID, datum and status), in the order of ids
+        **/
+        template <typename T>
+        std::vector<ReadResult<Protocol, T>>
+        read_results(const std::vector<id_t>& ids,
+            typename Protocol::address_t address)
+        {
+            std::vector<ReadResult<Protocol, T>> results;
+            results.reserve(ids.size());
+
+            for (auto id : ids) {
                 _serial_interface.send(
                     typename dynamixel::instructions::Read<Protocol>(
-                        servo.second->id(),
+                        id,
                         address,
                         sizeof(T)));
-                StatusPacket<Protocol> status;
-                _serial_interface.recv(status);
-
-                // unpack the data in the response and store it
-                T datum;
-                Protocol::unpack_data(status.parameters(), datum);
-                pairs.push_back(std::make_pair(servo.second->id(), datum));
+                results.push_back(
+                    recv_result<T, Protocol>(_serial_interface, id));
             }
 
-            return pairs;
+            return results;
         }
 
         /** Change the ID of one or all actuators.
@@ -254,6 +334,10 @@ namespace dynamixel {
                 _serial_interface.send(_servos.at(id)->set_id(new_id));
                 _serial_interface.recv(status);
             }
+            _eeprom.invalidate(id);
+            _eeprom.invalidate(new_id);
+            if (Protocol::broadcast_id != id)
+                _eeprom.set_size(new_id, _eeprom.size(id));
         }
 
         /** Change the baudrate of one or all actuators.
@@ -282,6 +366,7 @@ namespace dynamixel {
                 _serial_interface.send(_servos.at(id)->set_baudrate(baudrate));
                 _serial_interface.recv(status);
             }
+            _eeprom.invalidate(id);
         }
 
         /** Reset the Control Table to its initial factory default settings.
@@ -307,8 +392,29 @@ namespace dynamixel {
                 _serial_interface.send(FactoryReset<Protocol>(id));
                 _serial_interface.recv(status);
             }
+            _eeprom.invalidate(id);
+        }
+
+        /** Operating mode of an actuator.
+
+            It is computed from the EEPROM area of the actuator, which is read
+            once and then kept in a cache until it is written through this
+            object.
+
+            @param id ID of the servo
+            @throws errors::Error if the actuator does not answer
+        **/
+        OperatingMode operating_mode(id_t id)
+        {
+            return dynamixel::operating_mode(_serial_interface, id, _eeprom);
         }
 
+        /// Cache of the EEPROM area of the actuators (@see EepromCache)
+        EepromCache<Protocol>& eeprom() { return _eeprom; }
+
+        /// Connection to the actuators, for the operations not wrapped here
+        const Usb2Dynamixel& serial_interface() const { return _serial_interface; }
+
         /** Move one servo to a given angle
 
             @param id ID of the servo
@@ -342,15 +448,8 @@ namespace dynamixel {
         void set_angle(const std::vector<id_t>& ids, double angle)
         {
             check_scanned();
-            for (auto id : ids) {
-                _serial_interface.send(_servos.at(id)->reg_goal_position_angle(angle));
-
-                StatusPacket<Protocol> status;
-                _serial_interface.recv(status);
-            }
 
-            _serial_interface.send(
-                dynamixel::instructions::Action<Protocol>(Protocol::broadcast_id));
+            set_angle(ids, std::vector<double>(ids.size(), angle));
         }
 
         /** Move servos to a given angle
@@ -366,15 +465,7 @@ namespace dynamixel {
         {
             check_scanned();
 
-            for (auto servo : _servos) {
-                _serial_interface.send(servo.second->reg_goal_position_angle(angle));
-
-                StatusPacket<Protocol> status;
-                _serial_interface.recv(status);
-            }
-
-            _serial_interface.send(
-                dynamixel::instructions::Action<Protocol>(Protocol::broadcast_id));
+            set_angle(_detected_ids(), angle);
         }
 
         /** Move servos to a given angle
@@ -398,23 +489,26 @@ namespace dynamixel {
                 throw errors::UtilityError("set_position(vector, vector): the "
                                            "vectors of IDs and angles should have "
                                            "the same length");
-            for (int i = 0; i < ids.size(); i++) {
-                _serial_interface.send(
-                    _servos.at(ids[i])->reg_goal_position_angle(angles[i]));
 
-                StatusPacket<Protocol> status;
-                _serial_interface.recv(status);
+            // the values are all encoded before anything is sent, and the
+            // actuators whose goal position has the same address and width are
+            // moved by the same sync write
+            BatchWrite<Protocol> batch;
+            for (size_t i = 0; i < ids.size(); i++) {
+                const std::shared_ptr<BaseServo<Protocol>>& servo = _servos.at(ids[i]);
+                batch.add(ids[i], servo->goal_position_field(), servo->goal_position_angle_data(angles[i]));
             }
-
-            if (ids.size() > 0)
-                _serial_interface.send(
-                    dynamixel::instructions::Action<Protocol>(Protocol::broadcast_id));
+            batch.send(_serial_interface);
         }
 
-        /** Move servos to a given angle
+        /** Move servos to a given angle, with the fewest possible packets
             This version moves each servo to its own angle
-            IMPORTANT : optimal version, works only with Model Mx28
-            TODO : generalize to all models !
+
+            The angles are converted with the model of each servo. The servos
+            whose goal position has the same address and width share a sync
+            write; with version 2 of the protocol, servos with different
+            layouts are moved by a single bulk write.
+
             @param ids vector of ids for the servos to be moved
             @param angles vector of angles, one for each actuator
 
@@ -433,13 +527,14 @@ namespace dynamixel {
                 throw errors::UtilityError("set_position(vector, vector): the "
                                            "vectors of IDs and angles should have "
                                            "the same length");
-            _serial_interface.send(
-                std::make_shared<servos::Mx28>(0)->set_goal_positions<id_t, double>(ids, angles));
 
-            StatusPacket<Protocol> status;
-            for (int i = 0; i < ids.size(); i++) {
-                _serial_interface.recv(status);
+            BatchWrite<Protocol> batch;
+            for (size_t i = 0; i < ids.size(); i++) {
+                const std::shared_ptr<BaseServo<Protocol>>& servo = _servos.at(ids[i]);
+                batch.add(ids[i], servo->goal_position_field(), servo->goal_position_angle_data(angles[i]));
             }
+            // sync and bulk writes have no reply
+            batch.send(_serial_interface, true);
         }
 
         /** Give current angular position (rad) of desired servos
@@ -454,25 +549,13 @@ namespace dynamixel {
         {
             check_scanned();
 
-            std::vector<double> positions;
-
-            for (auto id : ids) {
-                StatusPacket<Protocol> status;
-                // request current position
-                _serial_interface.send(_servos.at(id)->get_present_position_angle());
-                _serial_interface.recv(status);
+            std::vector<StatusPacket<Protocol>> replies = _read_fields(ids,
+                &BaseServo<Protocol>::present_position_field, "its position");
 
-                // parse response to get the position
-                if (status.valid())
-                    positions.push_back(
-                        _servos.at(id)->parse_present_position_angle(status));
-                else {
-                    std::stringstream message;
-                    message << (int)id << " did not answer to the request for "
-                            << "its position";
-                    throw errors::Error(message.str());
-                }
-            }
+            std::vector<double> positions;
+            for (size_t i = 0; i < ids.size(); ++i)
+                positions.push_back(
+                    _servos.at(ids[i])->parse_present_position_angle(replies[i]));
 
             return positions;
         }
@@ -490,68 +573,22 @@ namespace dynamixel {
         {
             check_scanned();
 
-            std::vector<double> positions;
-            std::vector<id_t> ids;
-
-            for (auto servo : _servos) {
-                StatusPacket<Protocol> status;
-                // request current position
-                _serial_interface.send(
-                    servo.second->get_present_position_angle());
-                _serial_interface.recv(status);
-
-                // parse response to get the position
-                if (status.valid()) {
-                    positions.push_back(
-                        servo.second->parse_present_position_angle(status));
-                    ids.push_back(servo.first);
-                }
-                else {
-                    std::stringstream message;
-                    message << (int)servo.first << " did not answer to the request for "
-                            << "its position";
-                    throw errors::Error(message.str());
-                }
-            }
+            std::vector<id_t> ids = _detected_ids();
 
-            return std::make_pair(ids, positions);
+            return std::make_pair(ids, get_angle(ids));
         }
 
+        /** Give current angular position (rad) of all connected servos
+
+            Same as get_angle(), which reads the positions with bulk (or sync)
+            reads, at the address of the model of each servo.
+        **/
         std::pair<std::vector<id_t>, std::vector<double>>
         get_angle_bulk() const
         {
             check_scanned();
 
-            std::vector<double> positions;
-            std::vector<id_t> ids;
-
-            for (auto servo : _servos) {
-                ids.push_back(servo.first);
-            }
-
-            _serial_interface.send(
-                std::make_shared<servos::Mx28>(0)->get_current_positions<id_t>(ids));
-
-            StatusPacket<Protocol> status;
-            for (auto servo : _servos) {
-
-                //  std::cout << "recv status : " << (int)servo.first << std::endl;
-                _serial_interface.recv(status);
-
-                // parse response to get the position
-                if (status.valid()) {
-
-                    positions.push_back(
-                        servo.second->parse_present_position_angle(status));
-                }
-                else {
-                    std::stringstream message;
-                    message << (int)servo.first << " did not answer to the request for "
-                            << "its position";
-                    throw errors::Error(message.str());
-                }
-            }
-            return std::make_pair(ids, positions);
+            return get_angle();
         }
 
         /** Give a speed target for a given set of servos.
@@ -576,19 +613,7 @@ namespace dynamixel {
         {
             check_scanned();
 
-            // the new speed is sent to each actuator but they wait for the
-            // "Action" (see bellow) command to enact the change
-            for (auto id : ids) {
-                _serial_interface.send(_servos.at(id)->reg_moving_speed_angle(
-                    speed,
-                    wheel_mode ? OperatingMode::wheel : OperatingMode::joint));
-
-                StatusPacket<Protocol> status;
-                _serial_interface.recv(status);
-            }
-
-            _serial_interface.send(
-                dynamixel::instructions::Action<Protocol>(Protocol::broadcast_id));
+            set_speed(ids, std::vector<double>(ids.size(), speed), wheel_mode);
         }
 
         /** Give a speed target for a given set of servos.
@@ -609,18 +634,7 @@ namespace dynamixel {
         {
             check_scanned();
 
-            // the new speed is sent to each actuator but they wait for the
-            // "Action" (see bellow) command to enact the change
-            for (auto servo : _servos) {
-                _serial_interface.send(servo.second->reg_moving_speed_angle(speed,
-                    wheel_mode ? OperatingMode::wheel : OperatingMode::joint));
-
-                StatusPacket<Protocol> status;
-                _serial_interface.recv(status);
-            }
-
-            _serial_interface.send(
-                dynamixel::instructions::Action<Protocol>(Protocol::broadcast_id));
+            set_speed(_detected_ids(), speed, wheel_mode);
         }
 
         /** Give a speed target for a given set of servos.
@@ -650,23 +664,41 @@ namespace dynamixel {
                                            "vectors of IDs and speeds should "
                                            "have the same length");
 
-            for (int i = 0; i < ids.size(); i++) {
-                _serial_interface.send(
-                    _servos.at(ids[i])->reg_moving_speed_angle(speeds[i],
-                        wheel_mode ? OperatingMode::wheel : OperatingMode::joint));
 
-                StatusPacket<Protocol> status;
-                _serial_interface.recv(status);
+            // all the speeds are encoded before anything is sent; one sync
+            // write per address and width of the moving speed field
+            BatchWrite<Protocol> batch;
+            for (size_t i = 0; i < ids.size(); i++) {
+                const std::shared_ptr<BaseServo<Protocol>>& servo = _servos.at(ids[i]);
+                batch.add(ids[i], servo->moving_speed_field(),
+                    servo->moving_speed_angle_data(speeds[i],
+                        wheel_mode ? OperatingMode::wheel : OperatingMode::joint));
             }
-
-            if (ids.size() > 0)
-                _serial_interface.send(
-                    dynamixel::instructions::Action<Protocol>(Protocol::broadcast_id));
+            batch.send(_serial_interface);
         }
-        //template <typename Model> // servos::Mx28>
+
+        /** Give a speed target for a given set of servos, with the fewest
+            possible packets
+
+            The speeds are converted with the model of each servo. The servos
+            whose moving speed has the same address and width share a sync
+            write; with version 2 of the protocol, servos with different
+            layouts are given their speed by a single bulk write.
+
+            @param ids vector of ids for the servos to be moved
+            @param speeds vector of angular velocities (rad/s), one for each actuator
+            @param wheel_mode boolean set to true if the actuators are in wheel
+                mode (defaults to false)
+
+            @throws out_of_range if the id is not among the detected servos
+            @throws dynamixel::errors::ServoLimitError if speed is out of the
+                servo's feasible bounds
+            @throws errors::UtilityError if the ids and speeds vectors have different
+                lengths or if you didn't detect connected servos before
+        **/
         void set_speed_sync(
             const std::vector<id_t>& ids,
-            const std::vector<double>& speeds)
+            const std::vector<double>& speeds, bool wheel_mode = false)
         {
             check_scanned();
             if (ids.size() != speeds.size())
@@ -674,13 +706,15 @@ namespace dynamixel {
                                            "vectors of IDs and speeds should have "
                                            "the same length");
 
-            _serial_interface.send(
-                std::make_shared<servos::Mx28>(0)->set_moving_speeds<id_t, double>(ids, speeds, OperatingMode::wheel));
-
-            StatusPacket<Protocol> status;
-            for (int i = 0; i < ids.size(); i++) {
-                _serial_interface.recv(status);
+            BatchWrite<Protocol> batch;
+            for (size_t i = 0; i < ids.size(); i++) {
+                const std::shared_ptr<BaseServo<Protocol>>& servo = _servos.at(ids[i]);
+                batch.add(ids[i], servo->moving_speed_field(),
+                    servo->moving_speed_angle_data(speeds[i],
+                        wheel_mode ? OperatingMode::wheel : OperatingMode::joint));
             }
+            // sync and bulk writes have no reply
+            batch.send(_serial_interface, true);
         }
 
         /** Give goal angular velocity (rad/s) of desired servos
@@ -695,25 +729,12 @@ namespace dynamixel {
         {
             check_scanned();
 
-            std::vector<double> speeds;
+            std::vector<StatusPacket<Protocol>> replies = _read_fields(ids,
+                &BaseServo<Protocol>::moving_speed_field, "its speed");
 
-            for (auto id : ids) {
-                StatusPacket<Protocol> status;
-                // request current position
-                _serial_interface.send(_servos.at(id)->get_moving_speed());
-                _serial_interface.recv(status);
-
-                // parse response to get the position
-                if (status.valid())
-                    speeds.push_back(
-                        _servos.at(id)->parse_joint_speed(status));
-                else {
-                    std::stringstream message;
-                    message << (int)id << " did not answer to the request for "
-                            << "its position";
-                    throw errors::Error(message.str());
-                }
-            }
+            std::vector<double> speeds;
+            for (size_t i = 0; i < ids.size(); ++i)
+                speeds.push_back(_servos.at(ids[i])->parse_joint_speed(replies[i]));
 
             return speeds;
         }
@@ -732,31 +753,9 @@ namespace dynamixel {
         {
             check_scanned();
 
-            std::vector<double> speeds;
-            std::vector<id_t> ids;
-
-            for (auto servo : _servos) {
-                StatusPacket<Protocol> status;
-                // request current position
-                _serial_interface.send(
-                    servo.second->get_moving_speed());
-                _serial_interface.recv(status);
+            std::vector<id_t> ids = _detected_ids();
 
-                // parse response to get the position
-                if (status.valid()) {
-                    speeds.push_back(
-                        servo.second->parse_joint_speed(status));
-                    ids.push_back(servo.first);
-                }
-                else {
-                    std::stringstream message;
-                    message << (int)servo.first << " did not answer to the request for "
-                            << "its position";
-                    throw errors::Error(message.str());
-                }
-            }
-
-            return std::make_pair(ids, speeds);
+            return std::make_pair(ids, get_speed(ids));
         }
 
         /** Enable (or disable) an actuator.
@@ -782,11 +781,12 @@ namespace dynamixel {
 
             StatusPacket<Protocol> status;
             if (Protocol::broadcast_id == id) {
-                for (auto servo : _servos) {
-                    _serial_interface.send(
-                        servo.second->set_torque_enable((int)enable));
-                    _serial_interface.recv(status);
-                }
+                // one sync write per address of the torque enable field
+                BatchWrite<Protocol> batch;
+                for (auto servo : _servos)
+                    batch.add(servo.first, servo.second->torque_enable_field(),
+                        Protocol::pack_data((uint8_t)enable));
+                batch.send(_serial_interface);
             }
             else {
                 _serial_interface.send(
@@ -808,26 +808,13 @@ namespace dynamixel {
         {
             check_scanned();
 
-            std::vector<bool> torque_enable;
-
-            for (auto id : ids) {
-                StatusPacket<Protocol> status;
-
-                // request whether torque is enabled
-                _serial_interface.send(_servos.at(id)->get_torque_enable());
-                _serial_interface.recv(status);
+            std::vector<StatusPacket<Protocol>> replies = _read_fields(ids,
+                &BaseServo<Protocol>::torque_enable_field, "its torque enabling status");
 
-                // parse response to know whether torque is enabled
-                if (status.valid())
-                    torque_enable.push_back(
-                        _servos.at(id)->parse_torque_enable(status));
-                else {
-                    std::stringstream message;
-                    message << (int)id << " did not answer to the request for "
-                            << "its torque enabling status";
-                    throw errors::Error(message.str());
-                }
-            }
+            std::vector<bool> torque_enable;
+            for (size_t i = 0; i < ids.size(); ++i)
+                torque_enable.push_back(
+                    _servos.at(ids[i])->parse_torque_enable(replies[i]));
 
             return torque_enable;
         }
@@ -847,32 +834,9 @@ namespace dynamixel {
         {
             check_scanned();
 
-            std::vector<id_t> ids;
-            std::vector<bool> torque_enable;
-
-            for (auto servo : _servos) {
-                StatusPacket<Protocol> status;
-
-                // request whether torque is enabled
-                _serial_interface.send(
-                    servo.second->get_torque_enable());
-                _serial_interface.recv(status);
-
-                // parse response to know whether torque is enabled
-                if (status.valid()) {
-                    torque_enable.push_back(
-                        servo.second->parse_torque_enable(status));
-                    ids.push_back(servo.first);
-                }
-                else {
-                    std::stringstream message;
-                    message << (int)servo.first << " did not answer to the request for "
-                            << "its torque enabling status";
-                    throw errors::Error(message.str());
-                }
-            }
+            std::vector<id_t> ids = _detected_ids();
 
-            return std::make_pair(ids, torque_enable);
+            return std::make_pair(ids, get_torque_enable(ids));
         }
 
     protected:
@@ -888,12 +852,70 @@ namespace dynamixel {
                                            "actuators before trying to retrieve them");
         }
 
+        /// IDs of all the detected servos
+        std::vector<id_t> _detected_ids() const
+        {
+            std::vector<id_t> ids;
+            for (auto servo : _servos)
+                ids.push_back(servo.first);
+            return ids;
+        }
+
+        /** Read one field of several servos, with as few instructions as
+            possible (@see BatchRead).
+
+            @param ids IDs of the servos
+            @param fields location of the field, for each servo
+            @param what description of the field, for the error message
+            @return reply of each servo, in the order of ids
+
+            @throws errors::Error if one actuator did not reply properly
+        **/
+        template <typename Id>
+        std::vector<StatusPacket<Protocol>> _read_fields(const std::vector<Id>& ids,
+            const std::vector<Field<Protocol>>& fields, const std::string& what) const
+        {
+            BatchRead<Protocol> batch;
+            for (size_t i = 0; i < ids.size(); ++i) {
+                // the actuators of unknown model are read individually
+                auto servo = _servos.find(ids[i]);
+                batch.add(ids[i], fields[i], servo != _servos.end() && servo->second->supports_bulk_read());
+            }
+
+            std::vector<StatusPacket<Protocol>> replies;
+            std::vector<ReadStatus> statuses;
+            batch.read(_serial_interface, replies, statuses);
+
+            for (size_t i = 0; i < ids.size(); ++i) {
+                if (statuses[i] != ReadStatus::ok && statuses[i] != ReadStatus::servo_error) {
+                    std::stringstream message;
+                    message << (int)ids[i] << " did not answer to the request for "
+                            << what;
+                    throw errors::Error(message.str());
+                }
+            }
+
+            return replies;
+        }
+
+        /// @see _read_fields; the field of each servo is given by a BaseServo method
+        template <typename Id>
+        std::vector<StatusPacket<Protocol>> _read_fields(const std::vector<Id>& ids,
+            Field<Protocol> (BaseServo<Protocol>::*field)() const, const std::string& what) const
+        {
+            std::vector<Field<Protocol>> fields;
+            for (size_t i = 0; i < ids.size(); ++i)
+                fields.push_back((_servos.at(ids[i]).get()->*field)());
+            return _read_fields(ids, fields, what);
+        }
+
     private:
         Usb2Dynamixel _serial_interface;
         std::map<typename Protocol::id_t, std::shared_ptr<BaseServo<Protocol>>>
             _servos;
         bool _scanned;
         double _scan_timeout;
+        EepromCache<Protocol> _eeprom;
     }; // namespace dynamixel
 } // namespace dynamixel
 